@@ -68,12 +68,14 @@ if [ ! -f cadical/libcadical.a ]; then
 
     echo "Fetching CaDiCaL ..."
 
-    # Get CaDiCaL
+    # Get CaDiCaL and patch it (import of shared clauses as redundant clauses)
     git clone https://github.com/arminbiere/cadical
+    cd cadical
+    git checkout rel-1.3.0
+    patch -p1 < ../cadical.patch
     
     echo "Building CaDiCaL ..."
 
-    cd cadical
     ./configure
     make
     cp build/libcadical.a .
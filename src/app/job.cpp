@@ -5,6 +5,7 @@
 
 #include "assert.h"
 #include "app/job.hpp"
+#include "data/job_placement.hpp"
 #include "util/logger.hpp"
 #include "util/sys/timer.hpp"
 
@@ -19,7 +20,8 @@ Job::Job(const Parameters& params, int commSize, int worldRank, int jobId) :
     _growth_period = _params.getFloatParam("g");
     _continuous_growth = _params.isNotNull("cg");
     _max_demand = _params.getIntParam("md");
-    _threads_per_job = _params.getIntParam("t");
+    // Threads are split evenly among the jobs which share a worker
+    _threads_per_job = std::max(1, _params.getIntParam("t") / std::max(1, _params.getIntParam("ajpw")));
 }
 
 void Job::updateJobTree(int index, int rootRank, int parentRank) {
@@ -109,34 +111,9 @@ bool Job::isDestructible() {
 
 int Job::getDemand(int prevVolume, float elapsedTime) const {
     if (_state == ACTIVE) {
-        int commSize = _job_tree.getCommSize();
-        int demand; 
-        if (_growth_period <= 0) {
-            // Immediate growth
-            demand = _job_tree.getCommSize();
-        } else {
-            if (_time_of_activation <= 0) demand = 1;
-            else {
-                float t = elapsedTime-_time_of_activation;
-                
-                // Continuous growth
-                float numPeriods = t/_growth_period;
-                if (!_continuous_growth) {
-                    // Discrete periodic growth
-                    numPeriods = std::floor(numPeriods);
-                    demand = std::min(commSize, (1 << (int)(numPeriods + 1)) - 1);
-                } else {
-                    // d(0) := 1; d := 2d+1 every <growthPeriod> seconds
-                    demand = std::min(commSize, (int)std::pow(2, numPeriods + 1) - 1);
-                }
-            }
-        }
-
-        // Limit demand if desired
-        if (_max_demand > 0) {
-            demand = std::min(demand, _max_demand);
-        }
-        return demand;
+        float activeTime = _time_of_activation <= 0 ? -1 : elapsedTime-_time_of_activation;
+        return JobPlacement::getDemand(_job_tree.getCommSize(), activeTime, 
+                _growth_period, _continuous_growth, _max_demand);
         
     } else {
         // "frozen"
@@ -143,10 +143,13 @@ public:
             _dormant_children_num_fails.erase(rank);
     }
 
-    bool isTransitiveParentOf(int index) {
-        if (index == _index) return true;
-        int lower = _index, upper = _index;
-        while (lower < _comm_size) {
+    bool isTransitiveParentOf(int index) const {
+        return isTransitiveParentOf(_index, index, _comm_size);
+    }
+    static bool isTransitiveParentOf(int parentIndex, int index, int commSize) {
+        if (index == parentIndex) return true;
+        int lower = parentIndex, upper = parentIndex;
+        while (lower < commSize) {
             lower = getLeftChildIndex(lower);
             upper = getRightChildIndex(upper);
             if (lower <= index && index <= upper) return true;
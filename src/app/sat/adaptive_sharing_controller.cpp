@@ -0,0 +1,58 @@
+
+#include <algorithm>
+
+#include "adaptive_sharing_controller.hpp"
+
+AdaptiveSharingController::AdaptiveSharingController(float defaultPeriod, int defaultBaseSize, float boundFactor) :
+    _default_period(defaultPeriod), _default_base_size(defaultBaseSize),
+    _bound_factor(std::max(1.0f, boundFactor)),
+    _period(defaultPeriod), _base_size(defaultBaseSize) {}
+
+void AdaptiveSharingController::onGather(float time) {
+    _time_of_last_round = time;
+    if (_time_of_pending_gather < 0) _time_of_pending_gather = time;
+}
+
+void AdaptiveSharingController::onBroadcast(float time, float period, int baseSize) {
+    _period = period;
+    _base_size = baseSize;
+    if (_time_of_pending_gather >= 0) {
+        _last_latency = time - _time_of_pending_gather;
+        _time_of_pending_gather = -1;
+    }
+    // Begin the next round in phase with all other nodes
+    _time_of_last_round = time;
+}
+
+const char* AdaptiveSharingController::adapt(float fillRatio, float duplicateRatio, float latency) {
+
+    float period = _period;
+    float baseSize = _base_size;
+    const char* reason;
+    if (latency > 0.5f * period) {
+        // Communication takes up much of the period: share less often
+        period *= 1.25f;
+        reason = "slow all-reduce";
+    } else if (duplicateRatio > 0.5f) {
+        // Most clauses are redundant across solvers: reduce the budget
+        baseSize *= 0.8f;
+        reason = "many duplicates";
+    } else if (fillRatio >= 0.9f) {
+        // Buffers are saturated with distinct clauses: share more often
+        // as long as communication is cheap, otherwise share more at once
+        if (latency < 0.25f * period && period > _default_period / _bound_factor) {
+            period *= 0.8f;
+        } else baseSize *= 1.25f;
+        reason = "saturated buffers";
+    } else if (fillRatio < 0.25f) {
+        // Solvers do not fill the buffers: give them more time
+        period *= 1.25f;
+        reason = "underfull buffers";
+    } else reason = "keep";
+
+    _period = std::max(_default_period / _bound_factor,
+            std::min(_default_period * _bound_factor, period));
+    _base_size = (int) std::max(_default_base_size / _bound_factor,
+            std::min(_default_base_size * _bound_factor, baseSize));
+    return reason;
+}
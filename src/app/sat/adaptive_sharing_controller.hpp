@@ -0,0 +1,51 @@
+
+#ifndef DOMPASCH_MALLOB_ADAPTIVE_SHARING_CONTROLLER_HPP
+#define DOMPASCH_MALLOB_ADAPTIVE_SHARING_CONTROLLER_HPP
+
+/*
+Sharing period and clause buffer base size of one job node, and (at the root)
+the policy which adapts them to the feedback of each sharing round (-acs).
+Both values are kept within [1/boundFactor, boundFactor] times their defaults.
+
+A node begins a sharing round one period after its last round. With adaptive
+sharing, a received broadcast also re-phases this timer: all leaves begin their
+next round one period after the same broadcast, so the time from a node's
+contribution to the answering broadcast measures the all-reduction itself and
+not the offset between free-running timers of different leaves.
+*/
+class AdaptiveSharingController {
+
+private:
+    const float _default_period;
+    const int _default_base_size;
+    const float _bound_factor;
+
+    float _period;
+    int _base_size;
+
+    float _time_of_last_round = 0;
+    // Time of the oldest own contribution which was not yet answered by a broadcast
+    float _time_of_pending_gather = -1;
+    float _last_latency = 0;
+
+public:
+    AdaptiveSharingController(float defaultPeriod, int defaultBaseSize, float boundFactor);
+
+    float getPeriod() const {return _period;}
+    int getBaseSize() const {return _base_size;}
+    // Time (seconds) from the last answered contribution of this node to the broadcast
+    float getLastLatency() const {return _last_latency;}
+
+    // Whether it is time for this node to begin a (timed) sharing round
+    bool isTimeToGather(float time) const {return time - _time_of_last_round >= _period;}
+    // This node sent its contribution to its parent at the given time
+    void onGather(float time);
+    // This node received a broadcast carrying the root's current decision
+    void onBroadcast(float time, float period, int baseSize);
+
+    // [root] Adapts period and base size to the feedback of a finished round.
+    // Returns a short description of the decision.
+    const char* adapt(float fillRatio, float duplicateRatio, float latency);
+};
+
+#endif
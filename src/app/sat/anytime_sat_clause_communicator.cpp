@@ -2,6 +2,7 @@
 #include "anytime_sat_clause_communicator.hpp"
 
 #include "util/logger.hpp"
+#include "util/sys/timer.hpp"
 #include "comm/mympi.hpp"
 #include "hordesat/utilities/clause_filter.hpp"
 
@@ -12,25 +13,59 @@ void AnytimeSatClauseCommunicator::handle(int source, JobMessage& msg) {
 
         int numAggregated = msg.payload.back();
         msg.payload.pop_back();
-        std::vector<int>& clauses = msg.payload;
-        testConsistency(clauses, getBufferLimit(numAggregated, BufferMode::ALL));
+        int baseSize = _sharing_controller.getBaseSize();
+        if (_adaptive_sharing) {
+            // The child's buffer may have been limited by a base size adopted earlier
+            baseSize = msg.payload.back();
+            msg.payload.pop_back();
+            // Aggregate the feedback of the child's subtree
+            _max_comm_latency = std::max(_max_comm_latency, 0.001f * msg.payload.back());
+            msg.payload.pop_back();
+            _num_duplicate_clauses += msg.payload.back();
+            msg.payload.pop_back();
+            _num_produced_clauses += msg.payload.back();
+            msg.payload.pop_back();
+        }
+        std::vector<int> clauses = _use_compact_encoding ? decode(msg.payload) : std::move(msg.payload);
+        testConsistency(clauses, getBufferLimit(numAggregated, BufferMode::ALL, baseSize));
         
         log(V5_DEBG, "%s : receive s=%i\n", _job->toStr(), clauses.size());
         
         // Add received clauses to local set of collected clauses
-        _clause_buffers.push_back(clauses);
+        _clause_buffers.push_back(std::move(clauses));
         _num_aggregated_nodes += numAggregated;
 
         if (canSendClauses()) sendClausesToParent();
 
     } else if (msg.tag == MSG_DISTRIBUTE_CLAUSES) {
         // Learn received clauses, send them to children
-        broadcastAndLearn(msg.payload);
+        if (_adaptive_sharing) {
+            // Adopt the sharing parameters decided by the root,
+            // measure the latency of this node's contribution and re-phase its timer
+            int baseSize = msg.payload.back();
+            msg.payload.pop_back();
+            float period = 0.001f * msg.payload.back();
+            msg.payload.pop_back();
+            _sharing_controller.onBroadcast(Timer::elapsedSeconds(), period, baseSize);
+        }
+        if (_use_compact_encoding) {
+            // Forward the encoded clauses as they are, decode them once for learning
+            std::vector<int> clauses = decode(msg.payload);
+            testConsistency(clauses, 0);
+            sendClausesToChildren(msg.payload);
+            learnClauses(clauses);
+        } else {
+            broadcastAndLearn(msg.payload);
+        }
     }
 }
 
 size_t AnytimeSatClauseCommunicator::getBufferLimit(int numAggregatedNodes, BufferMode mode) {
-    float limit = _clause_buf_base_size * std::pow(_clause_buf_discount_factor, std::log2(numAggregatedNodes+1));
+    return getBufferLimit(numAggregatedNodes, mode, _sharing_controller.getBaseSize());
+}
+
+size_t AnytimeSatClauseCommunicator::getBufferLimit(int numAggregatedNodes, BufferMode mode, int baseSize) {
+    float limit = baseSize * std::pow(_clause_buf_discount_factor, std::log2(numAggregatedNodes+1));
     if (mode == SELF) {
         return std::ceil(limit);
     } else {
@@ -65,6 +100,19 @@ void AnytimeSatClauseCommunicator::sendClausesToParent() {
     std::vector<int> clausesToShare = prepareClauses();
 
     if (_job->getJobTree().isRoot()) {
+        if (_adaptive_sharing) {
+            float fillRatio = (float)clausesToShare.size() / getBufferLimit(_num_aggregated_nodes, BufferMode::ALL);
+            float duplicateRatio = _num_produced_clauses == 0 ? 0 
+                    : std::min(1.0f, (float)_num_duplicate_clauses / _num_produced_clauses);
+            float period = _sharing_controller.getPeriod();
+            int baseSize = _sharing_controller.getBaseSize();
+            const char* reason = _sharing_controller.adapt(fillRatio, duplicateRatio, _max_comm_latency);
+            bool changed = period != _sharing_controller.getPeriod() || baseSize != _sharing_controller.getBaseSize();
+            log(changed ? V3_VERB : V4_VVER, "%s : adapt sharing fill=%.3f dup=%.3f lat=%.3f : s=%.3f->%.3f cbbs=%i->%i (%s)\n", 
+                    _job->toStr(), fillRatio, duplicateRatio, _max_comm_latency, period, _sharing_controller.getPeriod(), 
+                    baseSize, _sharing_controller.getBaseSize(), reason);
+        }
+        _sharing_controller.onGather(Timer::elapsedSeconds());
         // Share complete set of clauses to children
         broadcastAndLearn(clausesToShare);
     } else {
@@ -74,18 +122,28 @@ void AnytimeSatClauseCommunicator::sendClausesToParent() {
         msg.jobId = _job->getId();
         msg.epoch = 0; // unused
         msg.tag = MSG_GATHER_CLAUSES;
-        msg.payload = clausesToShare;
+        msg.payload = _use_compact_encoding ? encode(clausesToShare) : std::move(clausesToShare);
         log(LOG_ADD_DESTRANK | V4_VVER, "%s : gather s=%i", parentRank, _job->toStr(), msg.payload.size());
+        if (_adaptive_sharing) {
+            msg.payload.push_back(_num_produced_clauses);
+            msg.payload.push_back(_num_duplicate_clauses);
+            msg.payload.push_back((int) (1000 * std::max(_max_comm_latency, _sharing_controller.getLastLatency())));
+            msg.payload.push_back(_sharing_controller.getBaseSize());
+        }
         msg.payload.push_back(_num_aggregated_nodes);
         MyMpi::isend(MPI_COMM_WORLD, parentRank, MSG_SEND_APPLICATION_MESSAGE, msg);
+        _sharing_controller.onGather(Timer::elapsedSeconds());
     }
 
     _num_aggregated_nodes = 0;
+    _num_produced_clauses = 0;
+    _num_duplicate_clauses = 0;
+    _max_comm_latency = 0;
 }
 
 void AnytimeSatClauseCommunicator::broadcastAndLearn(const std::vector<int>& clauses) {
     testConsistency(clauses, 0);
-    sendClausesToChildren(clauses);
+    sendClausesToChildren(_use_compact_encoding ? encode(clauses) : clauses);
     learnClauses(clauses);
 }
 
@@ -109,14 +167,18 @@ void AnytimeSatClauseCommunicator::learnClauses(const std::vector<int>& clauses)
     }
 }
 
-void AnytimeSatClauseCommunicator::sendClausesToChildren(const std::vector<int>& clauses) {
+void AnytimeSatClauseCommunicator::sendClausesToChildren(const std::vector<int>& payload) {
     
     // Send clauses to children
     JobMessage msg;
     msg.jobId = _job->getId();
     msg.epoch = 0; // unused
     msg.tag = MSG_DISTRIBUTE_CLAUSES;
-    msg.payload = clauses;
+    msg.payload = payload;
+    if (_adaptive_sharing) {
+        msg.payload.push_back((int) (1000 * _sharing_controller.getPeriod()));
+        msg.payload.push_back(_sharing_controller.getBaseSize());
+    }
     int childRank;
     if (_job->getJobTree().hasLeftChild()) {
         childRank = _job->getJobTree().getLeftChildNodeRank();
@@ -130,6 +192,33 @@ void AnytimeSatClauseCommunicator::sendClausesToChildren(const std::vector<int>&
     }
 }
 
+std::vector<int> AnytimeSatClauseCommunicator::encode(const std::vector<int>& clauses) {
+    std::vector<int> payload;
+    ClauseBufferCodec::encode(clauses, payload);
+    log(V5_DEBG, "%s : encode s=%i -> s=%i\n", _job->toStr(), clauses.size(), payload.size());
+    return payload;
+}
+
+std::vector<int> AnytimeSatClauseCommunicator::decode(const std::vector<int>& payload) {
+    std::vector<int> clauses;
+    ClauseBufferCodec::decode(payload, clauses);
+    return clauses;
+}
+
+int AnytimeSatClauseCommunicator::getNumClauses(const std::vector<int>& buffer) {
+    if (buffer.empty()) return 0;
+    int numClauses = buffer[0];
+    size_t pos = 1;
+    for (int i = 0; i < buffer[0]; i++) while (buffer[pos++] != 0) {}
+    int length = 1;
+    while (pos < buffer.size()) {
+        numClauses += buffer[pos];
+        pos += buffer[pos] * length + 1;
+        length++;
+    }
+    return numClauses;
+}
+
 std::vector<int> AnytimeSatClauseCommunicator::prepareClauses() {
 
     // +1 for local clauses, but at most as many contributions as there are nodes
@@ -152,6 +241,7 @@ std::vector<int> AnytimeSatClauseCommunicator::prepareClauses() {
                     _job->toStr(), selfSize);
         selfClauses = _job->getPreparedClauses();
         testConsistency(selfClauses, 0 /*do not check buffer's size limit*/);
+        if (_adaptive_sharing) _num_produced_clauses += getNumClauses(selfClauses);
     }
     _clause_buffers.push_back(std::move(selfClauses));
 
@@ -167,15 +257,27 @@ std::vector<int> AnytimeSatClauseCommunicator::prepareClauses() {
 }
 
 std::vector<int> AnytimeSatClauseCommunicator::merge(size_t maxSize) {
+    
+    // Single allocation for the merged buffer
     std::vector<int> result;
+    result.reserve(maxSize);
+
+    // No more clauses than integers can be inserted into the result
+    // (or, for selection by LBD, be gathered from the input)
+    size_t totalInputSize = 0;
+    for (const auto& buf : _clause_buffers) totalInputSize += buf.size();
+    resetMergeArena(_select_by_lbd ? totalInputSize : std::min(maxSize, totalInputSize));
 
     // Position counter for each buffer
-    std::vector<int> positions(_clause_buffers.size(), 0);
+    size_t numBuffers = _clause_buffers.size();
+    auto& positions = _merge_positions;
+    positions.assign(numBuffers, 0);
 
     // How many VIP clauses in each buffer?
-    std::vector<int> nvips(_clause_buffers.size());
+    auto& nvips = _merge_counts;
+    nvips.resize(numBuffers);
     int totalNumVips = 0;
-    for (size_t i = 0; i < _clause_buffers.size(); i++) {
+    for (size_t i = 0; i < numBuffers; i++) {
         nvips[i] = (_clause_buffers[i].size() > 0) ? _clause_buffers[i][positions[i]] : 0;
         totalNumVips += nvips[i];
         positions[i]++;
@@ -183,56 +285,53 @@ std::vector<int> AnytimeSatClauseCommunicator::merge(size_t maxSize) {
 
     // Store number of VIP clauses of resulting buffer here
     result.push_back(0);
-    int& resvips = result[0];
 
-    std::vector<int> cls;
     int picked = -1;
     while (totalNumVips > 0) {
-        do picked = (picked+1) % nvips.size(); while (nvips[picked] == 0);
+        do picked = (picked+1) % numBuffers; while (nvips[picked] == 0);
+        const std::vector<int>& vec = _clause_buffers[picked];
         int& pos = positions[picked];
-        int lit = _clause_buffers[picked][pos++];
-        // Append to clause
-        cls.push_back(lit);
-        if (lit == 0) {
-            // Clause finished
-
-            // Clause buffer size limit reached?
-            if (result.size() + cls.size() > maxSize) break;
-
-            // Clause not seen yet?
-            if (_clause_filter.insert(cls).second) {
-                // Insert clause into result clause buffer
-                result.insert(result.end(), cls.begin(), cls.end());
-                resvips++;
-            }
 
-            /*
-            Logger::append(V5_DEBG, "VIP ");
-            for (int l : cls) Logger::append(V5_DEBG, "%i ", l);
-            log(V5_DEBG, "\n");*/
+        // Identify clause in place, including its separator zero
+        const int* begin = vec.data()+pos;
+        int size = 1;
+        while (begin[size-1] != 0) size++;
+        pos += size;
 
-            // Clear clause vector, update counters
-            cls.clear();
-            nvips[picked]--;
-            totalNumVips--;
-        }
+        // Clause buffer size limit reached?
+        if (result.size() + size > maxSize) break;
+
+        // Clause not seen yet?
+        if (insertIntoMergeArena(begin, size)) {
+            // Insert clause into result clause buffer
+            result.insert(result.end(), begin, begin+size);
+            result[0]++;
+        } else _num_duplicate_clauses++;
+
+        nvips[picked]--;
+        totalNumVips--;
     }
 
+    // Number of clauses of the current length in each buffer
+    auto& nclsoflen = _merge_counts;
+
+    // Selection by LBD: gather all distinct clauses first, select them afterwards
+    if (_select_by_lbd) _lbd_selector.clear();
+
     int clauseLength = 1;
     bool doContinue = true;
     while (doContinue) {
         doContinue = false;
 
-        if (result.size() + 1 + clauseLength > maxSize) {
+        if (!_select_by_lbd && result.size() + 1 + clauseLength > maxSize) {
             // No clauses of this size are fitting into the buffer any more: stop
             break;
         }
 
         // Get number of clauses of clauseLength for each buffer
         // and also the sum over all these numbers
-        std::vector<int> nclsoflen(_clause_buffers.size());
         int allclsoflen = 0;
-        for (size_t i = 0; i < _clause_buffers.size(); i++) {
+        for (size_t i = 0; i < numBuffers; i++) {
             nclsoflen[i] = positions[i] < (int)_clause_buffers[i].size() ? 
                             _clause_buffers[i][positions[i]] : 0;
             if (positions[i] < (int)_clause_buffers[i].size()) doContinue = true;
@@ -241,37 +340,36 @@ std::vector<int> AnytimeSatClauseCommunicator::merge(size_t maxSize) {
         }
 
         // Store number of inserted clauses of clauseLength in result[numpos]
-        result.push_back(0);
-        int numpos = result.size()-1;
+        int numpos = -1;
+        if (!_select_by_lbd) {
+            result.push_back(0);
+            numpos = result.size()-1;
+        }
         
         // Read clauses from buffers in a cyclic manner
         int picked = -1;
         while (allclsoflen > 0) {
             // Limit reached?
-            if (result.size() + clauseLength > maxSize) {
+            if (!_select_by_lbd && result.size() + clauseLength > maxSize) {
                 doContinue = false;
                 break;
             }
 
             // Identify next clause
-            do picked = (picked+1) % nvips.size(); while (nclsoflen[picked] == 0);
-            const std::vector<int>& vec = _clause_buffers[picked];
-            int pos = positions[picked];
-            auto begin = vec.begin()+pos;
-            auto end = vec.begin()+pos+clauseLength;
+            do picked = (picked+1) % numBuffers; while (nclsoflen[picked] == 0);
+            const int* begin = _clause_buffers[picked].data()+positions[picked];
 
             // Clause not included yet?
-            if (_clause_filter.insert(std::vector<int>(begin, end)).second) {
-                // Insert and increase corresponding counters
-                result.insert(result.end(), begin, end);
-                result[numpos]++;
-            }
-
-            /*
-            Logger::append(V5_DEBG, "CLS ");
-            for (int i = pos; i < pos+clauseLength; i++) 
-                Logger::append(V5_DEBG, "%i ", vec[i]);
-            log(V5_DEBG, "\n");*/
+            if (insertIntoMergeArena(begin, clauseLength)) {
+                if (_select_by_lbd) {
+                    // Candidate for the selection by LBD
+                    _lbd_selector.add(begin, clauseLength);
+                } else {
+                    // Insert and increase corresponding counters
+                    result.insert(result.end(), begin, begin+clauseLength);
+                    result[numpos]++;
+                }
+            } else _num_duplicate_clauses++;
 
             // Update counters for remaining clauses 
             positions[picked] += clauseLength;
@@ -282,15 +380,63 @@ std::vector<int> AnytimeSatClauseCommunicator::merge(size_t maxSize) {
         clauseLength++;
     }
 
+    if (_select_by_lbd) {
+        _lbd_selector.writeSelection(result, maxSize);
+        return result;
+    }
+
     // Remove trailing zeroes because they are unnecessary
     // (as long as the buffer does not become empty)
     while (result.size() > 1 && result.back() == 0 && result[result.size()-2] == 0) 
         result.pop_back();
 
-    _clause_filter.clear();
     return result;
 }
 
+void AnytimeSatClauseCommunicator::resetMergeArena(size_t maxNumClauses) {
+
+    // Keep the load factor of the arena at or below 1/2
+    size_t capacity = 16;
+    while (capacity < 2*maxNumClauses) capacity *= 2;
+    if (capacity > _merge_slots.size()) {
+        _merge_slots.assign(capacity, MergeSlot());
+        _merge_stamp = 0;
+    }
+
+    // Invalidate all slots of the previous merge at once
+    _merge_stamp++;
+    if (_merge_stamp == 0) {
+        // Stamp overflow: explicitly clear old stamps
+        for (auto& slot : _merge_slots) slot.stamp = 0;
+        _merge_stamp = 1;
+    }
+}
+
+bool AnytimeSatClauseCommunicator::insertIntoMergeArena(const int* begin, int size) {
+
+    // Same semantics as the clause filter's hash-based equality:
+    // Units are compared exactly, other clauses by their hash (glue is skipped)
+    size_t hash = ClauseFilter::hash(begin, size, 1, /*skipFirst=*/size > 1);
+    size_t mask = _merge_slots.size()-1;
+    size_t idx = hash & mask;
+
+    while (_merge_slots[idx].stamp == _merge_stamp) {
+        const MergeSlot& slot = _merge_slots[idx];
+        if (slot.size == size && (size == 1 ? slot.begin[0] == begin[0] : slot.hash == hash)) {
+            // Clause is already present
+            return false;
+        }
+        idx = (idx+1) & mask;
+    }
+
+    MergeSlot& slot = _merge_slots[idx];
+    slot.hash = hash;
+    slot.begin = begin;
+    slot.size = size;
+    slot.stamp = _merge_stamp;
+    return true;
+}
+
 bool AnytimeSatClauseCommunicator::testConsistency(const std::vector<int>& buffer, size_t maxSize) {
     if (buffer.empty()) return true;
 
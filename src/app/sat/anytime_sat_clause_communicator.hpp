@@ -3,11 +3,13 @@
 #define DOMPASCH_MALLOB_ANYTIME_SAT_CLAUSE_COMMUNICATOR_H
 
 #include "util/params.hpp"
-#include "util/robin_hood.hpp"
 #include "data/job_transfer.hpp"
 #include "app/job.hpp"
 #include "base_sat_job.hpp"
+#include "adaptive_sharing_controller.hpp"
 #include "hordesat/utilities/clause_filter.hpp"
+#include "hordesat/utilities/lbd_clause_selector.hpp"
+#include "hordesat/utilities/clause_buffer_codec.hpp"
 
 const int MSG_GATHER_CLAUSES = 417;
 const int MSG_DISTRIBUTE_CLAUSES = 418;
@@ -18,38 +20,78 @@ private:
     const Parameters& _params;
     BaseSatJob* _job = NULL;
 
-    const int _clause_buf_base_size;
     const float _clause_buf_discount_factor;
+    const bool _select_by_lbd;
+    const bool _use_compact_encoding;
 
     std::vector<std::vector<int>> _clause_buffers;
-    robin_hood::unordered_set<std::vector<int>, ClauseFilter::ClauseHasher, ClauseFilter::ClauseHashBasedEquals> _clause_filter;
     int _num_aggregated_nodes;
 
+    // Adaptive clause sharing (-acs): the root tunes the sharing period and the
+    // buffer base size within [1/acsf, acsf] times their configured values
+    // and broadcasts its decision together with the clauses.
+    const bool _adaptive_sharing;
+    AdaptiveSharingController _sharing_controller;
+    // Feedback of the current sharing round, aggregated up the job tree
+    int _num_produced_clauses = 0;
+    int _num_duplicate_clauses = 0;
+    float _max_comm_latency = 0;
+
+    // Open-addressing arena to deduplicate clauses during a merge.
+    // Slots point directly into the collected clause buffers and are
+    // invalidated in O(1) by incrementing the current stamp.
+    struct MergeSlot {
+        size_t hash;
+        const int* begin;
+        int size;
+        unsigned int stamp = 0;
+    };
+    std::vector<MergeSlot> _merge_slots;
+    unsigned int _merge_stamp = 0;
+    // Per-buffer cursors and counters reused across merges
+    std::vector<int> _merge_positions;
+    std::vector<int> _merge_counts;
+    LbdClauseSelector _lbd_selector;
+
     bool _initialized = false;
 
 public:
     AnytimeSatClauseCommunicator(const Parameters& params, BaseSatJob* job) : _params(params), _job(job), 
-        _clause_buf_base_size(_params.getIntParam("cbbs")), 
         _clause_buf_discount_factor(_params.getFloatParam("cbdf")),
-        _num_aggregated_nodes(0) {
+        _select_by_lbd(_params.getParam("cbsel") == "lbd"),
+        _use_compact_encoding(_params.getParam("cbenc") == "varint"),
+        _num_aggregated_nodes(0),
+        _adaptive_sharing(_params.isNotNull("acs")),
+        _sharing_controller(_params.getFloatParam("s"), _params.getIntParam("cbbs"), 
+            _params.getFloatParam("acsf")) {
 
         _initialized = true;
     }
     bool canSendClauses();
     void sendClausesToParent();
     void handle(int source, JobMessage& msg);
+    // Current period (seconds) in which leaves begin a sharing round
+    float getCommPeriod() const {return _sharing_controller.getPeriod();}
+    // Whether a leaf should begin its next sharing round
+    bool isTimeToGather(float time) const {return _sharing_controller.isTimeToGather(time);}
 
 private:
     
     enum BufferMode {SELF, ALL};
     size_t getBufferLimit(int numAggregatedNodes, BufferMode mode);
+    size_t getBufferLimit(int numAggregatedNodes, BufferMode mode, int baseSize);
 
     std::vector<int> prepareClauses();
     void broadcastAndLearn(const std::vector<int>& clauses);
     void learnClauses(const std::vector<int>& clauses);
-    void sendClausesToChildren(const std::vector<int>& clauses);
+    void sendClausesToChildren(const std::vector<int>& payload);
+    std::vector<int> encode(const std::vector<int>& clauses);
+    std::vector<int> decode(const std::vector<int>& payload);
+    int getNumClauses(const std::vector<int>& buffer);
 
     std::vector<int> merge(size_t maxSize);
+    void resetMergeArena(size_t maxNumClauses);
+    bool insertIntoMergeArena(const int* begin, int size);
     bool testConsistency(const std::vector<int>& buffer, size_t maxSize);
 };
 
@@ -145,10 +145,14 @@ bool ForkedSatJob::appl_wantsToBeginCommunication() {
     if (!_initialized || getState() != ACTIVE || _job_comm_period <= 0) return false;
     // Special "timed" conditions for leaf nodes:
     if (getJobTree().isLeaf()) {
-        // At least half a second since initialization / reactivation
-        if (getAgeSinceActivation() < 0.5 * _job_comm_period) return false;
-        // At least params["s"] seconds since last communication 
-        if (Timer::elapsedSeconds()-_time_of_last_comm < _job_comm_period) return false;
+        // Current sharing period: params["s"] or as adapted by the job's root
+        float period = _clause_comm == NULL ? _job_comm_period 
+                : ((AnytimeSatClauseCommunicator*) _clause_comm)->getCommPeriod();
+        // At least half a period since initialization / reactivation
+        if (getAgeSinceActivation() < 0.5 * period) return false;
+        // At least one period since last communication (or, with adaptive sharing, last broadcast)
+        if (_clause_comm == NULL || !((AnytimeSatClauseCommunicator*) _clause_comm)->isTimeToGather(Timer::elapsedSeconds())) 
+            return false;
     }
     if (!_solver_lock.tryLock()) return false;
     bool wants = ((AnytimeSatClauseCommunicator*) _clause_comm)->canSendClauses();
@@ -162,7 +166,6 @@ void ForkedSatJob::appl_beginCommunication() {
     auto lock = _solver_lock.getLock();
     if (_clause_comm != NULL) 
         ((AnytimeSatClauseCommunicator*) _clause_comm)->sendClausesToParent();
-    if (getJobTree().isLeaf()) _time_of_last_comm = Timer::elapsedSeconds();
 }
 
 void ForkedSatJob::appl_communicate(int source, JobMessage& msg) {
@@ -2,8 +2,10 @@
 #include <assert.h>
 #include <sys/types.h>
 #include <stdlib.h>
+#include <cmath>
 
 #include "horde_process_adapter.hpp"
+#include "sat_process_pool.hpp"
 
 #include "hordesat/horde.hpp"
 #include "util/sys/shared_memory.hpp"
@@ -29,19 +31,19 @@ void HordeProcessAdapter::initSharedMemory() {
     _hsm = new ((char*)mainShmem) HordeSharedMemory();
     _hsm->portfolioRank = atoi(_params["apprank"].c_str());
     _hsm->portfolioSize = atoi(_params["mpisize"].c_str());
-    _hsm->doExport = false;
-    _hsm->doImport = false;
-    _hsm->doDumpStats = false;
-    _hsm->doUpdateRole = false;
-    _hsm->doInterrupt = false;
+    _hsm->reqExport = 0;
+    _hsm->reqImport = 0;
+    _hsm->reqDumpStats = 0;
+    _hsm->reqUpdateRole = 0;
+    _hsm->reqInterrupt = 0;
     _hsm->doTerminate = false;
     _hsm->exportBufferMaxSize = 0;
     _hsm->importBufferSize = 0;
-    _hsm->didExport = false;
-    _hsm->didImport = false;
-    _hsm->didDumpStats = false;
-    _hsm->didUpdateRole = false;
-    _hsm->didInterrupt = false;
+    _hsm->ackExport = 0;
+    _hsm->ackImport = 0;
+    _hsm->ackDumpStats = 0;
+    _hsm->ackUpdateRole = 0;
+    _hsm->ackInterrupt = 0;
     _hsm->didTerminate = false;
     _hsm->isSpawned = false;
     _hsm->isInitialized = false;
@@ -49,6 +51,7 @@ void HordeProcessAdapter::initSharedMemory() {
     _hsm->result = UNKNOWN;
     _hsm->solutionSize = 0;
     _hsm->exportBufferTrueSize = 0;
+    _hsm->childWakeup.reset();
 
     // Put formula into its own block of shared memory
     int size = sizeof(int) * _f_size;
@@ -67,18 +70,23 @@ void HordeProcessAdapter::initSharedMemory() {
     _params.setParam("asmptbufsize", std::to_string(size));
 
     // Create block of shared memory for clause export
-    int maxExportBufferSize = _params.getIntParam("cbbs") * sizeof(int);
+    // (adaptive clause sharing may enlarge the buffers by up to a factor of acsf)
+    float maxBaseSize = _params.getIntParam("cbbs");
+    if (_params.isNotNull("acs")) maxBaseSize *= std::max(1.0f, _params.getFloatParam("acsf"));
+    int maxExportBufferSize = std::ceil(maxBaseSize) * sizeof(int);
     std::string exportShmemId = _shmem_id + ".clauseexport";
     _export_buffer = (int*) SharedMemory::create(exportShmemId, maxExportBufferSize);
     _shmem.push_back(std::tuple<std::string, void*, int>(exportShmemId, _export_buffer, maxExportBufferSize));
     memset(_export_buffer, 0, maxExportBufferSize);
+    _params.setParam("exportbufsize", std::to_string(maxExportBufferSize));
 
     // Create block of shared memory for clause import
-    int maxImportBufferSize = _params.getIntParam("cbbs") * sizeof(int) * _params.getIntParam("mpisize");
+    int maxImportBufferSize = std::ceil(maxBaseSize) * sizeof(int) * _params.getIntParam("mpisize");
     std::string importShmemId = _shmem_id + ".clauseimport";
     _import_buffer = (int*) SharedMemory::create(importShmemId, maxImportBufferSize);
     _shmem.push_back(std::tuple<std::string, void*, int>(importShmemId, _import_buffer, maxImportBufferSize));
     memset(_import_buffer, 0, maxImportBufferSize);
+    _params.setParam("importbufsize", std::to_string(maxImportBufferSize));
 }
 
 HordeProcessAdapter::~HordeProcessAdapter() {
@@ -89,6 +97,14 @@ HordeProcessAdapter::~HordeProcessAdapter() {
 
 pid_t HordeProcessAdapter::run() {
 
+    // Bind an idle pre-spawned SAT process, if available
+    pid_t pooledPid = SatProcessPool::bind(_params);
+    if (pooledPid > 0) {
+        _child_pid = pooledPid;
+        _state = SolvingStates::ACTIVE;
+        return pooledPid;
+    }
+
     // Assemble c-style program arguments
     const char* execName = "mallob_sat_process";
     char* const* argv = _params.asCArgs(execName);
@@ -130,6 +146,7 @@ void HordeProcessAdapter::setSolvingState(SolvingStates::SolvingState state) {
         //Fork::terminate(_child_pid); // Terminate child process by signal.
         _hsm->doTerminate = true; // Kindly ask child process to terminate.
         Process::resume(_child_pid); // Continue (resume) process.
+        _hsm->childWakeup.notify();
     }
     if (state == SolvingStates::SUSPENDED) {
         Process::suspend(_child_pid); // Stop (suspend) process.
@@ -138,7 +155,7 @@ void HordeProcessAdapter::setSolvingState(SolvingStates::SolvingState state) {
         Process::resume(_child_pid); // Continue (resume) process.
     }
     if (state == SolvingStates::STANDBY) {
-        _hsm->doInterrupt = true;
+        issue(_hsm->reqInterrupt);
     }
 
     _state = state;
@@ -147,48 +164,60 @@ void HordeProcessAdapter::setSolvingState(SolvingStates::SolvingState state) {
 void HordeProcessAdapter::updateRole(int rank, int size) {
     _hsm->portfolioRank = rank;
     _hsm->portfolioSize = size;
-    _hsm->doUpdateRole = true;
+    issue(_hsm->reqUpdateRole);
+}
+
+/*
+Each instruction X is requested by incrementing reqX. The release store
+publishes all data written for the instruction beforehand; the child
+responds with a release store of the request number to ackX, which
+publishes the instruction's results to the parent.
+*/
+void HordeProcessAdapter::issue(std::atomic_int& req) {
+    // Only the parent writes req
+    req.store(req.load(std::memory_order_relaxed)+1, std::memory_order_release);
+    _hsm->childWakeup.notify();
+}
+bool HordeProcessAdapter::isPending(const std::atomic_int& req, const std::atomic_int& ack) {
+    return ack.load(std::memory_order_acquire) != req.load(std::memory_order_relaxed);
 }
 
 void HordeProcessAdapter::collectClauses(int maxSize) {
+    // Export already requested, or its result not fetched yet?
+    if (_hsm->reqExport.load(std::memory_order_relaxed) != _num_fetched_exports) return;
     _hsm->exportBufferMaxSize = maxSize;
-    _hsm->doExport = true;
-    if (_hsm->isInitialized) Process::wakeUp(_child_pid);
+    issue(_hsm->reqExport);
 }
 bool HordeProcessAdapter::hasCollectedClauses() {
-    return _hsm->didExport;
+    return _hsm->reqExport.load(std::memory_order_relaxed) != _num_fetched_exports 
+        && !isPending(_hsm->reqExport, _hsm->ackExport);
 }
 std::vector<int> HordeProcessAdapter::getCollectedClauses() {
-    if (!_hsm->didExport) {
+    if (!hasCollectedClauses()) {
         return std::vector<int>();
     }
     std::vector<int> clauses(_hsm->exportBufferTrueSize);
     memcpy(clauses.data(), _export_buffer, clauses.size()*sizeof(int));
-    _hsm->doExport = false;
+    _num_fetched_exports = _hsm->reqExport.load(std::memory_order_relaxed);
     return clauses;
 }
 
 void HordeProcessAdapter::digestClauses(const std::vector<int>& clauses) {
-    if (_hsm->doImport && !_hsm->didImport) {
+    if (isPending(_hsm->reqImport, _hsm->ackImport)) {
         log(V1_WARN, "Still digesting previous batch of clauses: discard this batch\n");
         return;
     }
+    // The child does not read the import buffer any more
     _hsm->importBufferSize = clauses.size();
     memcpy(_import_buffer, clauses.data(), clauses.size()*sizeof(int));
-    _hsm->doImport = true;
-    if (_hsm->isInitialized) Process::wakeUp(_child_pid);
+    issue(_hsm->reqImport);
 }
 
 void HordeProcessAdapter::dumpStats() {
-    _hsm->doDumpStats = true;
-    // No hard need to wake up immediately
+    issue(_hsm->reqDumpStats);
 }
 
 bool HordeProcessAdapter::check() {
-    if (_hsm->didImport)     _hsm->doImport     = false;
-    if (_hsm->didUpdateRole) _hsm->doUpdateRole = false;
-    if (_hsm->didInterrupt)  _hsm->doInterrupt  = false;
-    if (_hsm->didDumpStats)  _hsm->doDumpStats  = false;
     return _hsm->hasSolution;
 }
 
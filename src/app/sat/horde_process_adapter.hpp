@@ -23,6 +23,8 @@ private:
     std::vector<std::tuple<std::string, void*, int>> _shmem;
     std::string _shmem_id;
     HordeSharedMemory* _hsm;
+    // Number of the last export request whose clauses have been fetched
+    int _num_fetched_exports = 0;
 
     int* _export_buffer;
     int* _import_buffer;
@@ -57,6 +59,8 @@ public:
 
 private:
     void initSharedMemory();
+    void issue(std::atomic_int& req);
+    bool isPending(const std::atomic_int& req, const std::atomic_int& ack);
 
 };
 
@@ -3,29 +3,37 @@
 #define DOMPASCH_MALLOB_HORDE_SHARED_MEMORY_HPP
 
 #include <sys/types.h>
+#include <atomic>
 
 #include "hordesat/solvers/portfolio_solver_interface.hpp"
+#include "util/sys/wakeup_event.hpp"
 
 struct HordeSharedMemory {
 
+    // Notified by the parent whenever an instruction is issued,
+    // and by the child's solvers whenever a result is found
+    WakeupEvent childWakeup;
+
     // Meta data parent->child
     int portfolioRank;
     int portfolioSize;
 
-    // Instructions parent->child
-    bool doExport;
-    bool doImport;
-    bool doDumpStats;
-    bool doUpdateRole;
-    bool doInterrupt;
+    // Instructions parent->child: The parent requests instruction X by incrementing
+    // reqX (release). The child executes X whenever reqX (acquire) differs from ackX
+    // and then responds by setting ackX to the value of reqX it has read (release).
+    std::atomic_int reqExport;
+    std::atomic_int reqImport;
+    std::atomic_int reqDumpStats;
+    std::atomic_int reqUpdateRole;
+    std::atomic_int reqInterrupt;
     bool doTerminate;
 
     // Responses child->parent
-    bool didExport;
-    bool didImport;
-    bool didDumpStats;
-    bool didUpdateRole;
-    bool didInterrupt;
+    std::atomic_int ackExport;
+    std::atomic_int ackImport;
+    std::atomic_int ackDumpStats;
+    std::atomic_int ackUpdateRole;
+    std::atomic_int ackInterrupt;
     bool didTerminate;
 
     // State alerts child->parent
@@ -118,7 +118,7 @@ void HordeLib::beginSolving(size_t fSize, const int* fLits, size_t aSize, const
 
 	for (size_t i = 0; i < _num_solvers; i++) {
 		_solver_threads.emplace_back(new SolverThread(
-			_params, _solver_interfaces[i], fSize, fLits, aSize, aLits, i, &_solution_found
+			_params, _solver_interfaces[i], fSize, fLits, aSize, aLits, i, &_solution_found, _solution_callback
 		));
 		_solver_threads.back()->start();
 	}
@@ -197,11 +197,11 @@ void HordeLib::dumpStats(bool final) {
 	SolvingStatistics locSolveStats;
 	for (size_t i = 0; i < _num_solvers; i++) {
 		SolvingStatistics st = _solver_interfaces[i]->getStatistics();
-		_logger.log(V2_INFO, "%sS%d pps:%lu decs:%lu cnfs:%lu mem:%0.2f recv:%lu digd:%lu disc:%lu\n",
+		_logger.log(V2_INFO, "%sS%d pps:%lu decs:%lu cnfs:%lu rsts:%lu mem:%0.2f prod:%lu recv:%lu digd:%lu disc:%lu\n",
 				final ? "END " : "",
 				_solver_interfaces[i]->getGlobalId(), 
-				st.propagations, st.decisions, st.conflicts, st.memPeak, 
-				st.receivedClauses, st.digestedClauses, st.discardedClauses);
+				st.propagations, st.decisions, st.conflicts, st.restarts, st.memPeak, 
+				st.producedClauses, st.receivedClauses, st.digestedClauses, st.discardedClauses);
 		locSolveStats.conflicts += st.conflicts;
 		locSolveStats.decisions += st.decisions;
 		locSolveStats.memPeak += st.memPeak;
@@ -42,12 +42,17 @@ private:
 	std::set<int> _failed_assumptions;
 	std::atomic_bool _solution_found = false;
 	std::atomic_bool _cleaned_up = false;
+	std::function<void()> _solution_callback;
 
 public:
 
     HordeLib(const Parameters& params, Logger&& loggingInterface);
 	~HordeLib();
 
+	// Set a function to be called (from a solver thread) whenever a solver
+	// finds a result. Must be set before solving begins.
+	void setSolutionCallback(const std::function<void()>& callback) {_solution_callback = callback;}
+
     void beginSolving(size_t fSize, const int* fLits, size_t aSize, const int* aLits);
 	void continueSolving(size_t fSize, const int* fLits, size_t aSize, const int* aLits);
 	void updateRole(int rank, int numNodes);
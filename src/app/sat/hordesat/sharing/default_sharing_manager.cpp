@@ -13,15 +13,27 @@
 DefaultSharingManager::DefaultSharingManager(
 		std::vector<std::shared_ptr<PortfolioSolverInterface>>& solvers, 
 		const Parameters& params, const Logger& logger)
-	: _solvers(solvers), _params(params), _logger(logger), _cdb(logger) {
+	: _solvers(solvers), _params(params), _logger(logger), 
+		// Clause sizes include the glue int in front of each non-unit clause (hmcl=0: no limit)
+		_cdb(logger, solvers.size(), params.getIntParam("hmcl") > 0 ? params.getIntParam("hmcl")+1 : 0, 
+			/*selectByLbd=*/params.getParam("cbsel") == "lbd") {
 
 	memset(_seen_clause_len_histogram, 0, CLAUSE_LEN_HIST_LENGTH*sizeof(unsigned long));
 	_stats.seenClauseLenHistogram = _seen_clause_len_histogram;
 
 	auto callback = [this](std::vector<int>& cls, int solverId) {processClause(cls, solverId);};
 	
+	if (params.isNotNull("scf")) {
+		if (_solvers.size() <= CCF_MAX_SOLVERS) {
+			_shared_filter.reset(new ConcurrentClauseFilter(/*maxClauseLen=*/params.getIntParam("hmcl", 0)));
+		} else {
+			_logger.log(V1_WARN, "[WARN] Shared clause filter supports at most %i solvers - using one filter per solver\n", 
+				CCF_MAX_SOLVERS);
+		}
+	}
     for (size_t i = 0; i < _solvers.size(); i++) {
-		_solver_filters.emplace_back(/*maxClauseLen=*/params.getIntParam("hmcl", 0), /*checkUnits=*/true);
+		if (_shared_filter) _all_solvers_mask |= ConcurrentClauseFilter::getSolverBit(i);
+		else _solver_filters.emplace_back(/*maxClauseLen=*/params.getIntParam("hmcl", 0), /*checkUnits=*/true);
 		_solvers[i]->setLearnedClauseCallback(callback);
 	}
 	_last_buffer_clear = Timer::elapsedSeconds();
@@ -73,11 +85,22 @@ void DefaultSharingManager::digestSharing(const int* begin, int buflen) {
 		while (clauseLen-1 >= (int)lens.size()) lens.push_back(0);
 		lens[clauseLen-1]++;
 
-		// Import clause into each solver if its filter allows it
-		for (size_t sid = 0; sid < _solvers.size(); sid++) {
-			if (_solver_filters[sid].registerClause(clsbegin, size)) {
-				_solvers[sid]->addLearnedClause(clsbegin, size);
-				added[sid]++;
+		if (_shared_filter) {
+			// Import clause into each solver which has not seen it yet
+			uint64_t recipients = _shared_filter->registerImportedClause(clsbegin, size, _all_solvers_mask);
+			for (size_t sid = 0; sid < _solvers.size(); sid++) {
+				if (recipients & ConcurrentClauseFilter::getSolverBit(sid)) {
+					_solvers[sid]->addLearnedClause(clsbegin, size);
+					added[sid]++;
+				}
+			}
+		} else {
+			// Import clause into each solver if its filter allows it
+			for (size_t sid = 0; sid < _solvers.size(); sid++) {
+				if (_solver_filters[sid].registerClause(clsbegin, size)) {
+					_solvers[sid]->addLearnedClause(clsbegin, size);
+					added[sid]++;
+				}
 			}
 		}
 
@@ -96,12 +119,13 @@ void DefaultSharingManager::digestSharing(const int* begin, int buflen) {
 		_logger.log(V3_VERB, "S%d imp=%d\n", sid, numClauses-added[sid]);
 	}
 
-	// Clear half of the clauses from the filter (probabilistically) if a clause filter half life is set
+	// Forget the oldest generation of clauses in the filters if a clause filter half life is set
 	if (_params.getIntParam("cfhl", 0) > 0 && Timer::elapsedSeconds() - _last_buffer_clear > _params.getIntParam("cfhl", 0)) {
-		_logger.log(V3_VERB, "forget half of clauses in filters\n");
+		_logger.log(V3_VERB, "age clause filters\n");
 		for (size_t sid = 0; sid < _solver_filters.size(); sid++) {
-			_solver_filters[sid].clearHalf();
+			_solver_filters[sid].age();
 		}
+		if (_shared_filter) _shared_filter->age();
 		_last_buffer_clear = Timer::elapsedSeconds();
 	}
 }
@@ -111,10 +135,14 @@ void DefaultSharingManager::processClause(std::vector<int>& cls, int solverId) {
 	// Add clause length to statistics
 	_seen_clause_len_histogram[cls.size() == 1 ? 1 : std::min(cls.size(), (size_t)CLAUSE_LEN_HIST_LENGTH)-1]++;
 
-	// Register clause in this solver's filter
-	if (_solver_filters[solverId].registerClause(cls)) {
+	// Register clause in this solver's filter (or in the shared filter)
+	bool admitted = _shared_filter ? 
+		_shared_filter->registerProducedClause(cls.data(), cls.size(), solverId)
+		: _solver_filters[solverId].registerClause(cls);
+	if (admitted) {
 		// Success - write clause into database if possible
-		if (_cdb.addClause(cls) == NULL) _stats.clausesDroppedAtExport++;
+		// (failures are counted by the database)
+		_cdb.addClause(solverId, cls);
 	} else {
 		// Clause was already registered before
 		_stats.clausesFilteredAtExport++;
@@ -122,5 +150,6 @@ void DefaultSharingManager::processClause(std::vector<int>& cls, int solverId) {
 }
 
 SharingStatistics DefaultSharingManager::getStatistics() {
+	_stats.clausesDroppedAtExport = _cdb.getNumDroppedClauses();
 	return _stats;
 }
@@ -14,6 +14,7 @@
 #include "app/sat/hordesat/sharing/sharing_manager_interface.hpp"
 #include "app/sat/hordesat/utilities/clause_database.hpp"
 #include "app/sat/hordesat/utilities/clause_filter.hpp"
+#include "app/sat/hordesat/utilities/concurrent_clause_filter.hpp"
 #include "util/params.hpp"
 
 #define CLAUSE_LEN_HIST_LENGTH 256
@@ -24,6 +25,9 @@ protected:
 	// associated solvers
 	std::vector<std::shared_ptr<PortfolioSolverInterface>>& _solvers;
 	std::vector<ClauseFilter> _solver_filters;
+	// Alternative to _solver_filters: a single filter for all solvers (-scf)
+	std::unique_ptr<ConcurrentClauseFilter> _shared_filter;
+	uint64_t _all_solvers_mask = 0;
 	
 	// global parameters
 	const Parameters& _params;
@@ -12,13 +12,13 @@
 #include "app/sat/hordesat/solvers/cadical.hpp"
 #include "app/sat/hordesat/utilities/debug_utils.hpp"
 
-const int CLAUSE_LEARN_INTERRUPT_THRESHOLD = 10000;
-
 Cadical::Cadical(const SolverSetup& setup)
 	: PortfolioSolverInterface(setup),
-	  solver(new CaDiCaL::Solver), terminator(*setup.logger), learner(*this) {
+	  solver(new CaDiCaL::Solver), terminator(*setup.logger), learner(*this, _setup, *solver) {
 	
 	solver->connect_terminator(&terminator);
+	// The learner exports clauses (once a callback is set) and imports shared clauses
+	solver->connect_learner(&learner);
 }
 
 void Cadical::addLiteral(int lit) {
@@ -44,17 +44,6 @@ void Cadical::setPhase(const int var, const bool phase) {
 // return 10 for SAT, 20 for UNSAT, 0 for UNKNOWN
 SatResult Cadical::solve(size_t numAssumptions, const int* assumptions) {
 
-	// add the learned clauses
-	learnMutex.lock();
-	for (auto clauseToAdd : learnedClauses) {
-		for (auto litToAdd : clauseToAdd) {
-			addLiteral(litToAdd);
-		}
-		addLiteral(0);
-	}
-	learnedClauses.clear();
-	learnMutex.unlock();
-
 	// set the assumptions
 	this->assumptions.clear();
 	for (size_t i = 0; i < numAssumptions; i++) {
@@ -112,21 +101,11 @@ std::set<int> Cadical::getFailedAssumptions() {
 }
 
 void Cadical::addLearnedClause(const int* begin, int size) {
-	auto lock = learnMutex.getLock();
-	if (size == 1) {
-		learnedClauses.emplace_back(begin, begin + 1);
-	} else {
-		// Skip glue in front of array
-		learnedClauses.emplace_back(begin + 1, begin + size);
-	}
-	if (learnedClauses.size() > CLAUSE_LEARN_INTERRUPT_THRESHOLD) {
-		setSolverInterrupt();
-	}
+	learner.addClauseToImport(begin, size);
 }
 
 void Cadical::setLearnedClauseCallback(const LearnedClauseCallback& callback) {
 	learner.setCallback(callback);
-	solver->connect_learner(&learner);
 }
 
 void Cadical::increaseClauseProduction() {
@@ -147,9 +126,12 @@ int Cadical::getSplittingVariable() {
 
 SolvingStatistics Cadical::getStatistics() {
 	SolvingStatistics st;
-	// Stats are currently not accessible for the outside
-	// The can be directly printed with
-	// solver->statistics();
+	st.conflicts = solver->conflicts();
+	st.decisions = solver->decisions();
+	st.propagations = solver->propagations();
+	st.restarts = solver->restarts();
+	// Peak memory is not tracked per solver instance
+	learner.fillStatistics(st);
 	return st;
 }
 
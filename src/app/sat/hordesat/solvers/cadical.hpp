@@ -24,9 +24,6 @@ class Cadical : public PortfolioSolverInterface {
 private:
 	std::unique_ptr<CaDiCaL::Solver> solver;
 
-	Mutex learnMutex;
-
-	std::vector<std::vector<int> > learnedClauses;
 	std::vector<int> assumptions;
 
 	HordeTerminator terminator;
@@ -56,7 +53,7 @@ public:
 	std::set<int> getFailedAssumptions() override;
 
 	// Add a learned clause to the formula
-	// The learned clauses might be added later or possibly never
+	// The learned clauses are imported by the solver during search as redundant clauses
 	void addLearnedClause(const int* begin, int size) override;
 
 	// Set a function that should be called for each learned clause
@@ -490,6 +490,26 @@ public:
   int64_t redundant () const;   // Number of active redundant clauses.
   int64_t irredundant () const; // Number of active irredundant clauses.
 
+  //------------------------------------------------------------------------
+  // Search statistics.  These can also be queried from a different thread
+  // while the solver is solving, in which case they may be slightly outdated.
+  //
+  //   require (VALID)
+  //   ensure (VALID)
+  //
+  int64_t conflicts () const;    // Number of conflicts.
+  int64_t decisions () const;    // Number of decisions.
+  int64_t propagations () const; // Number of propagations during search.
+  int64_t restarts () const;     // Number of restarts.
+
+  // Glue (LBD) of the learned clause which is currently being exported
+  // through the connected learner, i.e., only valid if called from within
+  // 'Learner::learning' or 'Learner::learn'.  Returns zero if the glue is
+  // unknown, e.g., for units or clauses which were not derived in conflict
+  // analysis.
+  //
+  int exported_glue () const;
+
   //------------------------------------------------------------------------
   // This function executes the given number of preprocessing rounds. It is
   // similar to 'solve' with 'limits ("preprocessing", rounds)' except that
@@ -826,12 +846,24 @@ public:
 // The 'learning' can check the size of the learn clause and only if it
 // returns true then the individual literals of the learned clause are given
 // to the learn through 'learn' one by one terminated by a zero literal.
+// The glue of the clause can be queried with 'Solver::exported_glue'.
+//
+// Learners can also import clauses learned elsewhere (e.g., by other
+// solvers working on the same formula).  If 'importing' returns true
+// during search, the solver backtracks to the root level and fetches
+// clauses through 'import' until it returns false.  Each clause is added
+// as a redundant clause with the provided glue and thus is subject to
+// clause database reduction like any clause learned by the solver itself.
 
 class Learner {
 public:
   virtual ~Learner () { }
   virtual bool learning (int size) = 0;
   virtual void learn (int lit) = 0;
+  virtual bool importing () { return false; }
+  virtual bool import (std::vector<int> & clause, int & glue) {
+    (void) clause, (void) glue; return false;
+  }
 };
 
 /*------------------------------------------------------------------------*/
@@ -1,13 +1,30 @@
 
+#include <atomic>
+#include <list>
+
 #include "app/sat/hordesat/solvers/cadical_interface.hpp"
 #include "app/sat/hordesat/solvers/portfolio_solver_interface.hpp"
+#include "util/sys/threading.hpp"
 
 struct HordeLearner : public CaDiCaL::Learner {
-	HordeLearner(PortfolioSolverInterface &portfolio) : _portfolio(portfolio) {}
+	HordeLearner(PortfolioSolverInterface &portfolio, const SolverSetup& setup, const CaDiCaL::Solver& solver) : 
+		_portfolio(portfolio), _setup(setup), _solver(solver), 
+		_soft_glue_limit(setup.softInitialMaxLbd), _hard_glue_limit(setup.hardInitialMaxLbd) {}
 	~HordeLearner() override {}
 
   	bool learning(int size) override {
-		return size <= _glueLimit;
+		if (!_callback) return false;
+		if (size == 1) {
+			_curr_glue = 1;
+			return true;
+		}
+		// Use the true glue of the clause as provided by the solver, or its size if unknown
+		_curr_glue = _solver.exported_glue();
+		if (_curr_glue <= 0 || _curr_glue > size) _curr_glue = size;
+		// Hard limits MUST be fulfilled, soft limits are the actual export criterion
+		// (the clause is only seen once, so there is no lenient second look as in Glucose)
+		if (size > (int)_setup.hardMaxClauseLength || _curr_glue > _hard_glue_limit) return false;
+		return size <= (int)_setup.softMaxClauseLength && _curr_glue <= _soft_glue_limit;
 	}
 
 	void learn(int lit) override {
@@ -16,31 +33,93 @@ struct HordeLearner : public CaDiCaL::Learner {
 			_currClause.push_back(lit);
 		} else {
 			// Received a zero - clause is finished
-			int glue = _currClause.size();
-
 			// Add (glue + 1) to the front of the clause if not at unit
-			if (glue != 1)
-		        _currClause.insert(_currClause.begin(), glue + 1);
+			if (_currClause.size() != 1)
+		        _currClause.insert(_currClause.begin(), _curr_glue + 1);
 
 			_callback(_currClause, _portfolio.getLocalId());
 			_currClause.clear();
+			_num_produced++;
+		}
+	}
+
+	// Called by the solver during search: are there clauses to import?
+	bool importing() override {
+		return _has_clauses_to_import.load(std::memory_order_relaxed);
+	}
+
+	// Called by the solver at the root level to fetch the next clause to import
+	bool import(std::vector<int>& clause, int& glue) override {
+		auto lock = _import_mutex.getLock();
+		if (_clauses_to_import.empty()) {
+			_has_clauses_to_import = false;
+			return false;
+		}
+		auto& [importGlue, importClause] = _clauses_to_import.front();
+		glue = importGlue;
+		clause = std::move(importClause);
+		_clauses_to_import.pop_front();
+		_num_digested++;
+		return true;
+	}
+
+	// Called from outside the solver thread: add a clause for import
+	// (glue + 1 in front of the clause if not at unit, like in exported clauses)
+	void addClauseToImport(const int* begin, int size) {
+		auto lock = _import_mutex.getLock();
+		_num_received++;
+		if (_clauses_to_import.size() >= MAX_NUM_CLAUSES_TO_IMPORT) {
+			// Solver does not keep up (e.g., suspended): discard clause
+			_num_discarded++;
+			return;
 		}
+		if (size == 1) {
+			_clauses_to_import.emplace_back(1, std::vector<int>(begin, begin + 1));
+		} else {
+			_clauses_to_import.emplace_back(begin[0] - 1, std::vector<int>(begin + 1, begin + size));
+		}
+		_has_clauses_to_import = true;
 	}
 
+    // Like in the Glucose adapter: first relax the hard limit, then the soft limit
     void incGlueLimit() {
-        if (_glueLimit < 8) _glueLimit++;
+        if (_hard_glue_limit < (int)_setup.hardFinalMaxLbd) _hard_glue_limit++;
+        else if (_soft_glue_limit < (int)_setup.softFinalMaxLbd) _soft_glue_limit++;
     }
 
     void setCallback(const LearnedClauseCallback& callback) {
         _callback = callback;
     }
 
+	// Export and import counts for the solver statistics
+	void fillStatistics(SolvingStatistics& st) {
+		auto lock = _import_mutex.getLock();
+		st.producedClauses = _num_produced;
+		st.receivedClauses = _num_received;
+		st.digestedClauses = _num_digested;
+		st.discardedClauses = _num_discarded;
+	}
+
 	private:
-        int _glueLimit = 2;
-        
 		LearnedClauseCallback _callback;
 
         PortfolioSolverInterface &_portfolio;
+		const SolverSetup& _setup;
+		const CaDiCaL::Solver& _solver;
+
+		int _soft_glue_limit;
+		int _hard_glue_limit;
+		int _curr_glue = 0;
 
 		std::vector<int> _currClause;
-};
\ No newline at end of file
+
+		Mutex _import_mutex;
+		std::list<std::pair<int, std::vector<int>>> _clauses_to_import;
+		std::atomic_bool _has_clauses_to_import = false;
+		static const size_t MAX_NUM_CLAUSES_TO_IMPORT = 100000;
+
+		std::atomic_ulong _num_produced = 0;
+		unsigned long _num_received = 0;
+		unsigned long _num_digested = 0;
+		unsigned long _num_discarded = 0;
+};
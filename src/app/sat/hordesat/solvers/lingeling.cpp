@@ -49,6 +49,7 @@ void cbProduceUnit(void* sp, int lit) {
 	std::vector<int> vcls(1, lit);
 	Lingeling* lp = (Lingeling*)sp;
 	lp->callback(vcls, lp->getLocalId());
+	lp->numProduced++;
 }
 
 void cbProduce(void* sp, int* cls, int glue) {
@@ -76,6 +77,7 @@ void cbProduce(void* sp, int* cls, int glue) {
 	}
 	//printf("glue = %d, size = %lu\n", glue, vcls.size());
 	lp->callback(vcls, lp->getLocalId());
+	lp->numProduced++;
 }
 
 void cbConsumeUnits(void* sp, int** start, int** end) {
@@ -372,6 +374,7 @@ SolvingStatistics Lingeling::getStatistics() {
 	st.decisions = lglgetdecs(solver);
 	st.propagations = lglgetprops(solver);
 	st.memPeak = lglmaxmb(solver);
+	st.producedClauses = numProduced;
 	st.receivedClauses = numReceived;
 	st.digestedClauses = numDigested;
 	st.discardedClauses = numDiscarded;
@@ -45,6 +45,7 @@ private:
 	std::vector<int> learnedClausesBuffer;
 	std::vector<int> learnedUnitsBuffer;
 	std::vector<int> learnedClause;
+	unsigned long numProduced = 0;
 	unsigned long numReceived = 0;
 	unsigned long numDigested = 0;
 	unsigned long numDiscarded = 0;
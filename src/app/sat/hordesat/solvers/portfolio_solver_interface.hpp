@@ -30,6 +30,7 @@ struct SolvingStatistics {
 	unsigned long decisions = 0;
 	unsigned long conflicts = 0;
 	unsigned long restarts = 0;
+	unsigned long producedClauses = 0;
 	unsigned long receivedClauses = 0;
 	unsigned long digestedClauses = 0;
 	unsigned long discardedClauses = 0;
@@ -12,11 +12,11 @@ using namespace SolvingStates;
 SolverThread::SolverThread(const Parameters& params,
          std::shared_ptr<PortfolioSolverInterface> solver, 
         size_t fSize, const int* fLits, size_t aSize, const int* aLits,
-        int localId, std::atomic_bool* finished) : 
+        int localId, std::atomic_bool* finished, const std::function<void()>& finishedCallback) : 
     _params(params), _solver_ptr(solver), _solver(*solver), 
     _logger(_solver.getLogger()), 
     _f_size(fSize), _f_lits(fLits), _a_size(aSize), _a_lits(aLits),
-    _local_id(localId), _finished_flag(finished) {
+    _local_id(localId), _finished_flag(finished), _finished_callback(finishedCallback) {
     
     _portfolio_rank = _params.getIntParam("apprank", 0);
     _portfolio_size = _params.getIntParam("mpisize", 1);
@@ -274,6 +274,7 @@ void SolverThread::reportResult(int res) {
             }
             _state = STANDBY;
             *_finished_flag = true;
+            if (_finished_callback) _finished_callback();
         }
     }
 }
@@ -49,12 +49,14 @@ private:
 
     std::atomic_bool _initialized = false;
     std::atomic_bool* _finished_flag;
+    std::function<void()> _finished_callback;
 
 
 public:
     SolverThread(const Parameters& params, std::shared_ptr<PortfolioSolverInterface> solver, 
                 size_t fSize, const int* fLits, size_t aSize, const int* aLits,
-                int localId, std::atomic_bool* finished);
+                int localId, std::atomic_bool* finished, 
+                const std::function<void()>& finishedCallback = std::function<void()>());
     ~SolverThread();
 
     void init();
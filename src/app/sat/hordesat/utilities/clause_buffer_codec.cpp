@@ -0,0 +1,104 @@
+
+#include <algorithm>
+#include <cstring>
+#include <assert.h>
+
+#include "clause_buffer_codec.hpp"
+
+void ClauseBufferCodec::writeLiterals(std::vector<uint8_t>& bytes, std::vector<unsigned int>& codes, 
+        const int* begin, int size) {
+    codes.resize(size);
+    for (int i = 0; i < size; i++) codes[i] = litToCode(begin[i]);
+    std::sort(codes.begin(), codes.end());
+    unsigned int last = 0;
+    for (unsigned int code : codes) {
+        writeVarint(bytes, code - last);
+        last = code;
+    }
+}
+
+void ClauseBufferCodec::encode(const std::vector<int>& buffer, std::vector<int>& out) {
+
+    thread_local std::vector<uint8_t> bytes;
+    thread_local std::vector<unsigned int> codes;
+    bytes.clear();
+    bytes.reserve(buffer.size() * 2);
+
+    if (!buffer.empty()) {
+        size_t pos = 0;
+
+        // VIP clauses: number of clauses, then each clause as its size followed by its literals
+        int numVips = buffer[pos++];
+        writeVarint(bytes, numVips);
+        for (int i = 0; i < numVips; i++) {
+            size_t end = pos;
+            while (buffer[end] != 0) end++;
+            writeVarint(bytes, end-pos);
+            writeLiterals(bytes, codes, buffer.data()+pos, end-pos);
+            pos = end+1;
+        }
+
+        // Length buckets: number of clauses, then each clause as its glue (if not a unit)
+        // followed by its literals
+        int length = 1;
+        while (pos < buffer.size()) {
+            int numCls = buffer[pos++];
+            writeVarint(bytes, numCls);
+            int numLits = length > 1 ? length-1 : 1;
+            for (int i = 0; i < numCls; i++) {
+                if (length > 1) writeVarint(bytes, buffer[pos++]);
+                writeLiterals(bytes, codes, buffer.data()+pos, numLits);
+                pos += numLits;
+            }
+            length++;
+        }
+        assert(pos == buffer.size());
+    }
+
+    // Pack bytes into ints
+    out.resize(1 + (bytes.size() + sizeof(int) - 1) / sizeof(int));
+    out[0] = bytes.size();
+    if (!bytes.empty()) memcpy(out.data()+1, bytes.data(), bytes.size());
+}
+
+void ClauseBufferCodec::decode(const std::vector<int>& encoded, std::vector<int>& out) {
+
+    out.clear();
+    if (encoded.empty() || encoded[0] == 0) return;
+
+    const uint8_t* pos = (const uint8_t*) (encoded.data()+1);
+    const uint8_t* end = pos + encoded[0];
+    assert(encoded[0] <= (int) ((encoded.size()-1) * sizeof(int)));
+    out.reserve(encoded[0]);
+
+    // VIP clauses
+    int numVips = readVarint(pos);
+    out.push_back(numVips);
+    for (int i = 0; i < numVips; i++) {
+        int size = readVarint(pos);
+        unsigned int code = 0;
+        for (int j = 0; j < size; j++) {
+            code += readVarint(pos);
+            out.push_back(codeToLit(code));
+        }
+        out.push_back(0);
+    }
+
+    // Length buckets
+    int length = 1;
+    while (pos < end) {
+        int numCls = readVarint(pos);
+        out.push_back(numCls);
+        int numLits = length > 1 ? length-1 : 1;
+        for (int i = 0; i < numCls; i++) {
+            if (length > 1) out.push_back(readVarint(pos));
+            unsigned int code = 0;
+            for (int j = 0; j < numLits; j++) {
+                code += readVarint(pos);
+                out.push_back(codeToLit(code));
+            }
+        }
+        length++;
+    }
+    assert(pos == end);
+}
@@ -0,0 +1,47 @@
+
+#ifndef DOMPASCH_MALLOB_CLAUSE_BUFFER_CODEC_HPP
+#define DOMPASCH_MALLOB_CLAUSE_BUFFER_CODEC_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/*
+Compact wire encoding of clause buffers (see ClauseDatabase::giveSelection for the format).
+The structure of the buffer (VIP clauses, length buckets and their counters) is preserved.
+Within each clause, the literals are sorted and delta-encoded; all numbers are written
+as variable-length integers (7 bits per byte). The resulting bytes are packed into ints,
+preceded by the number of bytes, so that the encoded buffer can be sent like a plain one.
+Decoding yields the original buffer up to the order of literals within each clause.
+*/
+class ClauseBufferCodec {
+
+public:
+    static void encode(const std::vector<int>& buffer, std::vector<int>& out);
+    static void decode(const std::vector<int>& encoded, std::vector<int>& out);
+
+private:
+    static inline unsigned int litToCode(int lit) {return 2*(unsigned int)(lit < 0 ? -lit : lit) + (lit < 0);}
+    static inline int codeToLit(unsigned int code) {return (code & 1) ? -(int)(code >> 1) : (int)(code >> 1);}
+
+    static inline void writeVarint(std::vector<uint8_t>& bytes, unsigned int x) {
+        while (x >= 0x80) {
+            bytes.push_back((uint8_t)(x | 0x80));
+            x >>= 7;
+        }
+        bytes.push_back((uint8_t)x);
+    }
+    static inline unsigned int readVarint(const uint8_t*& pos) {
+        unsigned int x = 0;
+        int shift = 0;
+        while (*pos & 0x80) {
+            x |= (unsigned int)(*pos++ & 0x7f) << shift;
+            shift += 7;
+        }
+        x |= (unsigned int)(*pos++) << shift;
+        return x;
+    }
+    static void writeLiterals(std::vector<uint8_t>& bytes, std::vector<unsigned int>& codes, const int* begin, int size);
+};
+
+#endif
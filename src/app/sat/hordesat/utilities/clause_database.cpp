@@ -12,35 +12,34 @@
 #include "clause_database.hpp"
 #include "app/sat/hordesat/utilities/debug_utils.hpp"
 
+ClauseDatabase::ClauseDatabase(const Logger& logger, int numProducers, int maxClauseSize, bool selectByLbd) : 
+		logger(logger), maxClauseSize(maxClauseSize), selectByLbd(selectByLbd) {
+	int numBuckets = MAX_BUCKETED_CLAUSE_SIZE;
+	if (maxClauseSize > 0 && maxClauseSize <= MAX_BUCKETED_CLAUSE_SIZE) numBuckets = maxClauseSize;
+	else overflowBucket.reset(new RingBuffer(OVERFLOW_BUCKET_SIZE, numProducers));
+	for (int s = 0; s < numBuckets; s++) {
+		buckets.emplace_back(new RingBuffer(BUCKET_SIZE, numProducers));
+	}
+	if (selectByLbd) bucketContentsPerSize.resize(numBuckets);
+}
+
 void ClauseDatabase::addVIPClause(std::vector<int>& clause) {
-	auto lock = addClauseLock.getLock();
+	auto lock = vipClauseLock.getLock();
 	vipClauses.push_back(clause);
 }
 
-int* ClauseDatabase::addClause(std::vector<int>& clause) {
-	if (addClauseLock.tryLock() == false) return NULL;
-
+bool ClauseDatabase::addClause(int producerId, const std::vector<int>& clause) {
 	unsigned int csize = clause.size();
-
-	while (buckets.size() < csize) {
-		Bucket* b = new Bucket();
-		buckets.push_back(b);
-	}
-	Bucket* b = buckets[csize-1];
-	unsigned int top = b->top;
-	if (top + csize < BUCKET_SIZE) {
-		// copy the clause
-		for (unsigned int i = 0; i < csize; i++) {
-			b->data[top + i] = clause[i];
-		}
-		// update top
-		b->top += csize;
-		addClauseLock.unlock();
-		return b->data + top;
+	bool added;
+	if (csize == 0 || (maxClauseSize > 0 && csize > (unsigned int)maxClauseSize)) {
+		added = false;
+	} else if (csize <= buckets.size()) {
+		added = buckets[csize-1]->produce(clause.data(), csize, /*addSeparationZero=*/false, producerId);
 	} else {
-		addClauseLock.unlock();
-		return NULL;
+		added = overflowBucket->produce(clause.data(), csize, /*addSeparationZero=*/true, producerId);
 	}
+	if (!added) numDropped++;
+	return added;
 }
 
 /**
@@ -55,8 +54,6 @@ int* ClauseDatabase::addClause(std::vector<int>& clause) {
  * until size ints are used.
  */
 unsigned int ClauseDatabase::giveSelection(int* buffer, unsigned int size, int* selectedCount) {
-	// lock clause adding
-	addClauseLock.lock();
 	// clear the buffer
 	memset(buffer, 0, sizeof(int)*size);
 	unsigned int used = 0;
@@ -64,6 +61,7 @@ unsigned int ClauseDatabase::giveSelection(int* buffer, unsigned int size, int*
 	used++;
 	// First add the VIP clauses
 	HORDE_DBG(printf("adding the %d VIP clauses.\n", vipClauses.size()));
+	vipClauseLock.lock();
 	while (!vipClauses.empty()) {
 		std::vector<int>& vipCls = vipClauses.back();
 		int len = vipCls.size();
@@ -74,43 +72,109 @@ unsigned int ClauseDatabase::giveSelection(int* buffer, unsigned int size, int*
 		buffer[used++] = 0;
 		vipClauses.pop_back();
 	}
+	vipClauseLock.unlock();
 	buffer[0] = used-1;
 
 	if (used >= size) {
 		logger.log(-1, "ERROR: vip clauses exceeded the buffer size.");
-		addClauseLock.unlock();
 		*selectedCount = 0;
 		return used;
 	}
 
 	int fitting = 0;
 	int notFitting = 0;
+	// Position after the last non-empty bucket (trailing empty buckets are omitted)
+	unsigned int usedUntilLastClause = used;
+
+	// Drain the overflow bucket, splitting it into its zero-separated clauses
+	overflowContents.clear();
+	std::vector<std::pair<unsigned int, unsigned int>> overflowClauses; // (begin, size)
+	if (overflowBucket) {
+		unsigned int top = overflowBucket->consumeAll(overflowContents);
+		unsigned int begin = 0;
+		for (unsigned int pos = 0; pos < top; pos++) {
+			if (overflowContents[pos] != 0) continue;
+			overflowClauses.emplace_back(begin, pos-begin);
+			begin = pos+1;
+		}
+	}
 
-	// The other clauses
-	for (unsigned int s = 0; s < buckets.size(); s++) {
-		Bucket* b = buckets[s];
+	if (selectByLbd) {
+		// Drain all buckets and rank all clauses by LBD
+		lbdSelector.clear();
+		for (unsigned int s = 0; s < buckets.size(); s++) {
+			auto& contents = bucketContentsPerSize[s];
+			contents.clear();
+			unsigned int top = buckets[s]->consumeAll(contents);
+			for (unsigned int pos = 0; pos < top; pos += s+1) {
+				lbdSelector.add(contents.data()+pos, s+1);
+			}
+		}
+		for (const auto& [begin, csize] : overflowClauses) {
+			lbdSelector.add(overflowContents.data()+begin, csize);
+		}
+		selection.assign(buffer, buffer+used);
+		fitting = lbdSelector.writeSelection(selection, size);
+		notFitting = lbdSelector.getNumCandidates() - fitting;
+		memcpy(buffer, selection.data(), sizeof(int)*selection.size());
+		usedUntilLastClause = selection.size();
+	}
+
+	// Writes the bucket of all <top> ints of clauses of length s+1 at <data>
+	auto writeBucket = [&](unsigned int s, const int* data, unsigned int top) {
 		unsigned int left = size - used;
-		if (b->top < left) {
+		if (top < left) {
 			// Bucket nr. s has clauses of length s+1
-			HORDE_DBG(printf("will copy all %d cls of length %d\n", b->top/(s+1), s+1);)
-			fitting += b->top/(s+1);
-			buffer[used++] = b->top/(s+1);
-			memcpy(buffer + used, b->data, sizeof(int)*b->top);
-			used += b->top;
+			HORDE_DBG(printf("will copy all %d cls of length %d\n", top/(s+1), s+1);)
+			fitting += top/(s+1);
+			buffer[used++] = top/(s+1);
+			memcpy(buffer + used, data, sizeof(int)*top);
+			used += top;
+			if (top > 0) usedUntilLastClause = used;
 		} else if (left > s+1) {
 			// If at least one clause can be copied (including the number of clauses)
 			// Bucket nr. s has clauses of length s+1
 			int copy = ((left-1)/(s+1))*(s+1);
 			buffer[used++] = copy/(s+1);
 			HORDE_DBG(printf("will copy %d cls of length %d\n", copy / (s+1), s+1);)
-			memcpy(buffer + used, b->data, sizeof(int)*copy);
+			memcpy(buffer + used, data, sizeof(int)*copy);
 			used += copy;
 			fitting += copy/(s+1);
-			notFitting += (b->top - copy)/(s+1);
+			notFitting += (top - copy)/(s+1);
+			if (copy > 0) usedUntilLastClause = used;
+		} else {
+			notFitting += top/(s+1);
+		}
+	};
+
+	// The other clauses
+	for (unsigned int s = 0; !selectByLbd && s < buckets.size(); s++) {
+		// Drain all clauses which were completely added so far;
+		// clauses which are still being written remain for the next selection
+		bucketContents.clear();
+		unsigned int top = buckets[s]->consumeAll(bucketContents);
+		writeBucket(s, bucketContents.data(), top);
+	}
+	if (!selectByLbd && !overflowClauses.empty()) {
+		// Group the long clauses by length and continue with the buckets of these lengths
+		for (auto& contents : overflowContentsPerSize) contents.clear();
+		for (const auto& [begin, csize] : overflowClauses) {
+			if (csize >= size) {
+				// Can never fit into the buffer
+				notFitting++;
+				continue;
+			}
+			unsigned int idx = csize - buckets.size() - 1;
+			if (idx >= overflowContentsPerSize.size()) overflowContentsPerSize.resize(idx+1);
+			auto& contents = overflowContentsPerSize[idx];
+			contents.insert(contents.end(), overflowContents.data()+begin, overflowContents.data()+begin+csize);
+		}
+		for (unsigned int idx = 0; idx < overflowContentsPerSize.size(); idx++) {
+			const auto& contents = overflowContentsPerSize[idx];
+			writeBucket(buckets.size()+idx, contents.data(), contents.size());
 		}
-		b->top = 0;
 	}
-	addClauseLock.unlock();
+	used = usedUntilLastClause;
 	int all = fitting + notFitting;
 	if (all > 0) {
 		logger.log(V5_DEBG, "%d fit %d (%d%%) didn't \n", fitting, notFitting, notFitting*100/(all));
@@ -183,9 +247,5 @@ const int* ClauseDatabase::getNextIncomingClause(int& size) {
 	return clsbegin;
 }
 
-ClauseDatabase::~ClauseDatabase() {
-	for (unsigned int i = 0; i < buckets.size(); i++) {
-		delete buckets[i];
-	}
-}
+ClauseDatabase::~ClauseDatabase() {}
 
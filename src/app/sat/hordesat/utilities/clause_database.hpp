@@ -9,26 +9,36 @@
 #define CLAUSEDATABASE_H_
 
 #include <vector>
+#include <memory>
+#include <atomic>
 
 #include "util/sys/threading.hpp"
 #include "util/logger.hpp"
+#include "util/ringbuffer.hpp"
+#include "app/sat/hordesat/utilities/lbd_clause_selector.hpp"
 
 #define BUCKET_SIZE 1000
-
-struct Bucket {
-	int data[BUCKET_SIZE];
-	unsigned int top;
-};
+// Clauses of up to this many ints have a ring buffer of their own;
+// all longer clauses share a single overflow ring buffer
+#define MAX_BUCKETED_CLAUSE_SIZE 256
+#define OVERFLOW_BUCKET_SIZE (10*BUCKET_SIZE)
 
 class ClauseDatabase {
 public:
-	ClauseDatabase(const Logger& logger) : logger(logger) {}
+	/**
+	 * numProducers: number of threads (solvers) which concurrently add clauses,
+	 * maxClauseSize: maximum number of ints (including glue) of an added clause (0: no limit),
+	 * selectByLbd: select clauses for sharing by LBD first instead of by length only
+	 */
+	ClauseDatabase(const Logger& logger, int numProducers, int maxClauseSize, bool selectByLbd = false);
 	virtual ~ClauseDatabase();
 
 	/**
-	 * Add a learned clause that you want to share. Return a pointer to it
+	 * Add a learned clause that you want to share. Lock-free; each producer
+	 * ID must be used by at most one thread. Return false if the clause was dropped
+	 * because the bucket of its length is full.
 	 */
-	int* addClause(std::vector<int>& clause);
+	bool addClause(int producerId, const std::vector<int>& clause);
 	/**
 	 * Add a very important learned clause that you want to share
 	 */
@@ -48,14 +58,31 @@ public:
 	 * Return false if no more clauses.
 	 */
 	const int* getNextIncomingClause(int& size);
+	/**
+	 * Number of clauses which could not be added so far.
+	 */
+	unsigned long getNumDroppedClauses() const {return numDropped;}
 
 private:
 	const Logger& logger;
-	Mutex addClauseLock;
+	Mutex vipClauseLock;
 
 	// Structures for EXPORTING
-	std::vector<Bucket*> buckets;
+	// One multi-producer ring buffer per clause size (bucket nr. s: size s+1)
+	std::vector<std::unique_ptr<RingBuffer>> buckets;
+	std::vector<int> bucketContents;
+	// Clauses longer than MAX_BUCKETED_CLAUSE_SIZE, separated by zeros (if not limited below)
+	int maxClauseSize;
+	std::unique_ptr<RingBuffer> overflowBucket;
+	std::vector<int> overflowContents;
+	std::vector<std::vector<int>> overflowContentsPerSize;
+	// For selection by LBD: contents of all buckets and the selector ranking them
+	bool selectByLbd;
+	std::vector<std::vector<int>> bucketContentsPerSize;
+	std::vector<int> selection;
+	LbdClauseSelector lbdSelector;
 	std::vector<std::vector<int> > vipClauses;
+	std::atomic_ulong numDropped {0};
 
 	// Structures for IMPORTING	
 	const int* incomingBuffer;
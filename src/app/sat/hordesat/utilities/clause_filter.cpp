@@ -9,29 +9,62 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>
+#define CLAUSE_HASH_HAS_CRC32C
+#endif
+
+// A clause's hash is the sum of the hash values of its literals, which makes
+// it independent of the order of the literals, followed by a final mixing step.
+// Literals are hashed with the CRC32C instruction (SSE4.2) if available and with
+// a multiply-xorshift otherwise. The choice is made once per process, so all
+// hash values within a process are consistent (they are never communicated).
+
+static uint64_t sumLiteralHashes(const int* begin, const int* end, uint32_t seed) {
+	uint64_t sum = 0;
+	for (auto it = begin; it != end; it++) {
+		uint64_t h = ((uint32_t) *it ^ seed) * 0xBF58476D1CE4E5B9ULL;
+		sum += h ^ (h >> 32);
+	}
+	return sum;
+}
 
-#define NUM_PRIMES 16
-
-static unsigned const int primes [] = {2038072819, 2038073287,	2038073761,	2038074317,
-		2038072823,	2038073321,	2038073767,	2038074319,
-		2038072847,	2038073341,	2038073789,	2038074329,
-		2038074751,	2038075231,	2038075751,	2038076267};
+#ifdef CLAUSE_HASH_HAS_CRC32C
+__attribute__((target("sse4.2")))
+static uint64_t sumLiteralHashesCrc32c(const int* begin, const int* end, uint32_t seed) {
+	uint64_t sum = 0;
+	for (auto it = begin; it != end; it++) {
+		// Squaring keeps the sum from being linear in the CRC values
+		uint64_t c = _mm_crc32_u32(seed, (uint32_t) *it);
+		sum += c*c + (c << 32);
+	}
+	return sum;
+}
+static const bool useCrc32c = []() {
+	__builtin_cpu_init();
+	return (bool) __builtin_cpu_supports("sse4.2");
+}();
+#endif
 
 size_t ClauseFilter::hash(const std::vector<int>& cls, int which, bool skipFirst) {
 	return hash(cls.data(), cls.size(), which, skipFirst);
 }
 
 size_t ClauseFilter::hash(const int* begin, int size, int which, bool skipFirst) {
-	size_t res = 0;
-	for (auto it = begin; it != begin+size; it++) {
-		if (skipFirst) {
-			skipFirst = false;
-			continue;
-		}
-		int lit = *it;
-		res ^= lit * primes[abs((lit^which) & 15)];
-	}
-	return res;
+	const int* end = begin+size;
+	if (skipFirst && size > 0) begin++;
+	uint32_t seed = 0x85EBCA6Bu * (uint32_t) which;
+#ifdef CLAUSE_HASH_HAS_CRC32C
+	uint64_t h = useCrc32c ? sumLiteralHashesCrc32c(begin, end, seed) : sumLiteralHashes(begin, end, seed);
+#else
+	uint64_t h = sumLiteralHashes(begin, end, seed);
+#endif
+	// Final mix, also distinguishing clauses of different lengths
+	h ^= (uint64_t) (end-begin) << 56;
+	h ^= h >> 33; h *= 0xff51afd7ed558ccdULL; h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ULL; h ^= h >> 33;
+	return h;
 }
 
 bool ClauseFilter::registerClause(const std::vector<int>& cls) {
@@ -40,21 +73,24 @@ bool ClauseFilter::registerClause(const std::vector<int>& cls) {
 
 bool ClauseFilter::registerClause(const int* begin, int size) {
 
-	if (size > 1) size--; // subtract "glue" int from total size
+	int numLits = size > 1 ? size-1 : size; // subtract "glue" int from total size
 
 	// Block clauses above maximum length
-	if (maxClauseLen > 0 && size > maxClauseLen) return false;
+	if (maxClauseLen > 0 && numLits > maxClauseLen) return false;
 
 	// unit clauses are checked explicitly
-	if (size == 1) { // Unit clause!
+	if (numLits == 1) { // Unit clause!
 		if (checkUnits) {
 
 			// Always admit unit clause if a check is not possible right now
 			if (!unitLock.tryLock()) return true; 
 			
 			int firstLit = *begin;
-			bool admit = !units.count(firstLit);
-			if (admit) units.insert(firstLit);
+			bool admit = true;
+			for (int g = 0; g < NUM_GENERATIONS; g++) {
+				if (units[g].count(firstLit)) admit = false;
+			}
+			if (admit) units[currentGen].insert(firstLit);
 
 			unitLock.unlock();
 			return admit;
@@ -62,42 +98,50 @@ bool ClauseFilter::registerClause(const int* begin, int size) {
 		return true;
 	}
 
-	size_t h1 = hash(begin, size, 1, true) % NUM_BITS;
-	size_t h2 = hash(begin, size, 2, true) % NUM_BITS;
-	size_t h3 = hash(begin, size, 3, true) % NUM_BITS;
-	size_t h4 = hash(begin, size, 4, true) % NUM_BITS;
-
-	if (s1.test(h1) && s1.test(h2) && s1.test(h3) && s1.test(h4)) {
-		return false;
-	} else {
-		s1.set(h1, true);
-		s1.set(h2, true);
-		s1.set(h3, true);
-		s1.set(h4, true);
-		return true;
+	// Derive the block and the bit positions inside the block from a single hash
+	uint64_t h = hash(begin, size, 1, /*skipFirst=*/true);
+	size_t blockIdx = (size_t) (((h >> 36) * NUM_BLOCKS) >> 28);
+	uint64_t masks[BLOCK_BITS / 64] = {0};
+	for (int p = 0; p < NUM_PROBES; p++) {
+		int bit = (h >> (9*p)) & (BLOCK_BITS-1);
+		masks[bit / 64] |= 1ULL << (bit % 64);
 	}
+
+	// Already contained in some generation?
+	for (int g = 0; g < NUM_GENERATIONS; g++) {
+		const Block& block = blocks[g][blockIdx];
+		bool contained = true;
+		for (int w = 0; w < BLOCK_BITS / 64; w++) {
+			if ((block.words[w] & masks[w]) != masks[w]) {
+				contained = false;
+				break;
+			}
+		}
+		if (contained) return false;
+	}
+
+	// Register in current generation
+	Block& block = blocks[currentGen][blockIdx];
+	for (int w = 0; w < BLOCK_BITS / 64; w++) block.words[w] |= masks[w];
+	return true;
 }
 
 void ClauseFilter::clear() {
-	s1.reset();
+	for (int g = 0; g < NUM_GENERATIONS; g++) {
+		memset(blocks[g].data(), 0, blocks[g].size() * sizeof(Block));
+	}
 	auto lock = unitLock.getLock();
-	units.clear();
+	for (int g = 0; g < NUM_GENERATIONS; g++) units[g].clear();
 }
 
-void ClauseFilter::clearHalf() {
-
-	// The probability to delete a single bit is set to 0.1591 (or 1591/10000).
-	// => P(clause is deleted) = P(one of four bits is removed) = 1 - (1-pDelete)^4 = 0.5.
-	for (size_t i = s1._Find_first(); i < s1.size(); i = s1._Find_next(i)) {
-		if (rand() % 10000 < 1591) s1.set(i, false); // unset bit
-	}
+void ClauseFilter::age() {
 
-	// Remove half of all unit clauses
-	std::vector<int> unitsToDelete;
-	for (int unit : units) {
-		if (rand() % 2 == 0) unitsToDelete.push_back(unit);
-	}
-	for (int unit : unitsToDelete) {
-		units.erase(unit);
+	// The oldest generation becomes the new current generation
+	int oldestGen = (currentGen+1) % NUM_GENERATIONS;
+	memset(blocks[oldestGen].data(), 0, blocks[oldestGen].size() * sizeof(Block));
+	{
+		auto lock = unitLock.getLock();
+		units[oldestGen].clear();
 	}
+	currentGen = oldestGen;
 }
@@ -9,13 +9,21 @@
 #define CLAUSEFILTER_H_
 
 #include <vector>
-#include <bitset>
+#include <cstdint>
 #include "util/robin_hood.hpp"
 
 #include "util/sys/threading.hpp"
 
 //#define NUM_BITS 268435399 // 32MB
-#define NUM_BITS 26843543 // 3,2MB
+#define NUM_BITS 26843543 // 3,2MB (in total over all generations)
+
+// Number of generations of registered clauses which are remembered
+#define NUM_GENERATIONS 2
+// Number of bits set for each clause, all within a single block
+#define NUM_PROBES 4
+// One block corresponds to a 64-byte cache line
+#define BLOCK_BITS 512
+#define NUM_BLOCKS (NUM_BITS / BLOCK_BITS / NUM_GENERATIONS)
 
 class ClauseFilter {
 
@@ -27,8 +35,7 @@ public:
 	};
 	struct UnitHasher {
 		std::size_t operator()(const int& unit) const {
-			std::vector<int> unitCls(1, unit);
-			return ClauseFilter::hash(unitCls, 1, false);
+			return ClauseFilter::hash(&unit, 1, 1, false);
 		}
 	};
 	struct ClauseHashBasedEquals {
@@ -41,23 +48,39 @@ public:
 	};
 
 private:
-	std::bitset<NUM_BITS> s1;
+	struct alignas(64) Block {
+		uint64_t words[BLOCK_BITS / 64];
+	};
+
+	// Blocked Bloom filter for each generation; the generation at index 
+	// currentGen receives new clauses, the others are only queried
+	std::vector<Block> blocks[NUM_GENERATIONS];
+	int currentGen = 0;
 	int maxClauseLen = 0;
 	bool checkUnits = false;
 
-	robin_hood::unordered_set<int, UnitHasher> units;
+	robin_hood::unordered_set<int, UnitHasher> units[NUM_GENERATIONS];
 	Mutex unitLock;
 
 public:
-	ClauseFilter() : maxClauseLen(0), checkUnits(false) {}
-	ClauseFilter(int maxClauseLen, bool checkUnits) : maxClauseLen(maxClauseLen), checkUnits(checkUnits) {}
-	ClauseFilter(const ClauseFilter& other) : maxClauseLen(other.maxClauseLen), checkUnits(other.checkUnits) {
-		s1 = other.s1;
-		units = other.units;
+	ClauseFilter() : ClauseFilter(0, false) {}
+	ClauseFilter(int maxClauseLen, bool checkUnits) : maxClauseLen(maxClauseLen), checkUnits(checkUnits) {
+		for (int g = 0; g < NUM_GENERATIONS; g++) blocks[g].resize(NUM_BLOCKS);
+		clear();
+	}
+	ClauseFilter(const ClauseFilter& other) : currentGen(other.currentGen), 
+			maxClauseLen(other.maxClauseLen), checkUnits(other.checkUnits) {
+		for (int g = 0; g < NUM_GENERATIONS; g++) {
+			blocks[g] = other.blocks[g];
+			units[g] = other.units[g];
+		}
 	}
-	ClauseFilter(ClauseFilter&& other) : maxClauseLen(other.maxClauseLen), checkUnits(other.checkUnits) {
-		s1 = std::move(other.s1);
-		units = std::move(other.units);
+	ClauseFilter(ClauseFilter&& other) : currentGen(other.currentGen), 
+			maxClauseLen(other.maxClauseLen), checkUnits(other.checkUnits) {
+		for (int g = 0; g < NUM_GENERATIONS; g++) {
+			blocks[g] = std::move(other.blocks[g]);
+			units[g] = std::move(other.units[g]);
+		}
 	}
 	virtual ~ClauseFilter() {}
 
@@ -73,10 +96,15 @@ public:
 	 */
 	void clear();
 
-	void clearHalf();
+	/**
+	 * Forget the oldest generation of registered clauses
+	 * and begin a new generation.
+	 */
+	void age();
 
 	/**
-	 * Hash function for clauses, order of literals is irrelevant
+	 * 64-bit hash function for clauses, order of literals is irrelevant.
+	 * <which> selects one of several independent hash functions.
 	 */
 	static size_t hash(const std::vector<int>& cls, int which, bool skipFirst);
 	static size_t hash(const int* first, int size, int which, bool skipFirst);
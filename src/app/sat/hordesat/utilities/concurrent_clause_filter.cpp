@@ -0,0 +1,107 @@
+
+#include "concurrent_clause_filter.hpp"
+
+#include "clause_filter.hpp"
+
+ConcurrentClauseFilter::ConcurrentClauseFilter(int maxClauseLen) : _max_clause_len(maxClauseLen) {
+	for (int g = 0; g < CCF_NUM_GENERATIONS; g++) {
+		_slots[g].reset(new Slot[CCF_NUM_SLOTS]);
+		_eviction_positions[g].reset(new std::atomic<uint8_t>[CCF_NUM_SLOTS / CCF_BUCKET_SIZE]);
+	}
+	clear();
+}
+
+bool ConcurrentClauseFilter::registerProducedClause(const int* begin, int size, int solverId) {
+
+	// Block clauses above maximum length (glue int excluded)
+	if (_max_clause_len > 0 && (size > 1 ? size-1 : size) > _max_clause_len) return false;
+
+	bool inserted;
+	Slot* slot = find(getKey(begin, size), /*insert=*/true, inserted);
+	slot->origins.fetch_or(getSolverBit(solverId), std::memory_order_relaxed);
+	return inserted;
+}
+
+uint64_t ConcurrentClauseFilter::registerImportedClause(const int* begin, int size, uint64_t allSolvers) {
+
+	bool inserted;
+	Slot* slot = find(getKey(begin, size), /*insert=*/true, inserted);
+
+	// Deliver to each solver which has not seen the clause, who will then know it
+	uint64_t origins = slot->origins.fetch_or(allSolvers, std::memory_order_relaxed);
+	return allSolvers & ~origins;
+}
+
+uint64_t ConcurrentClauseFilter::getKey(const int* begin, int size) {
+	// Unit clauses are identified exactly
+	if (size == 1) return (1ULL << 63) | (uint32_t) *begin;
+	// Other clauses by a hash of their literals (glue is skipped)
+	uint64_t key = ClauseFilter::hash(begin, size, 1, true) & ~(1ULL << 63);
+	return key == 0 ? 1 : key;
+}
+
+ConcurrentClauseFilter::Slot* ConcurrentClauseFilter::find(uint64_t key, bool insert, bool& inserted) {
+	inserted = false;
+
+	// (unit keys are not hashed, so mix them first)
+	uint64_t h = key;
+	h ^= h >> 33; h *= 0xff51afd7ed558ccdULL; h ^= h >> 33;
+	size_t bucket = (h & (CCF_NUM_SLOTS-1)) / CCF_BUCKET_SIZE;
+	size_t first = bucket * CCF_BUCKET_SIZE;
+
+	// Already contained in some generation?
+	// (slots are never freed individually, so no key lies behind a free slot)
+	int currentGen = _current_gen.load(std::memory_order_relaxed);
+	for (int i = 0; i < CCF_NUM_GENERATIONS; i++) {
+		Slot* slots = _slots[(currentGen+i) % CCF_NUM_GENERATIONS].get();
+		for (size_t idx = first; idx < first+CCF_BUCKET_SIZE; idx++) {
+			uint64_t slotKey = slots[idx].key.load(std::memory_order_relaxed);
+			if (slotKey == key) return &slots[idx];
+			if (slotKey == 0) break;
+		}
+	}
+	if (!insert) return nullptr;
+
+	// Claim the first free slot in the current generation
+	Slot* slots = _slots[currentGen].get();
+	for (size_t idx = first; idx < first+CCF_BUCKET_SIZE; idx++) {
+		uint64_t expected = 0;
+		if (slots[idx].key.compare_exchange_strong(expected, key, std::memory_order_relaxed)) {
+			inserted = true;
+			return &slots[idx];
+		}
+		// Inserted concurrently by someone else?
+		if (expected == key) return &slots[idx];
+	}
+
+	// Bucket is full: the slots were claimed front to back,
+	// so replace them (oldest first) in the same order
+	size_t pos = _eviction_positions[currentGen][bucket].fetch_add(1, std::memory_order_relaxed) % CCF_BUCKET_SIZE;
+	Slot& slot = slots[first+pos];
+	slot.origins.store(0, std::memory_order_relaxed);
+	slot.key.store(key, std::memory_order_relaxed);
+	inserted = true;
+	return &slot;
+}
+
+void ConcurrentClauseFilter::clear() {
+	for (int g = 0; g < CCF_NUM_GENERATIONS; g++) clearGeneration(g);
+}
+
+void ConcurrentClauseFilter::age() {
+	// The oldest generation becomes the new current generation
+	int oldestGen = (_current_gen.load()+1) % CCF_NUM_GENERATIONS;
+	clearGeneration(oldestGen);
+	_current_gen.store(oldestGen);
+}
+
+void ConcurrentClauseFilter::clearGeneration(int gen) {
+	Slot* slots = _slots[gen].get();
+	for (size_t idx = 0; idx < CCF_NUM_SLOTS; idx++) {
+		slots[idx].key.store(0, std::memory_order_relaxed);
+		slots[idx].origins.store(0, std::memory_order_relaxed);
+	}
+	for (size_t bucket = 0; bucket < CCF_NUM_SLOTS / CCF_BUCKET_SIZE; bucket++) {
+		_eviction_positions[gen][bucket].store(0, std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,84 @@
+
+#ifndef DOMPASCH_MALLOB_CONCURRENT_CLAUSE_FILTER_HPP
+#define DOMPASCH_MALLOB_CONCURRENT_CLAUSE_FILTER_HPP
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <assert.h>
+
+// Number of slots per generation (16 bytes each): 8MB per generation
+#define CCF_NUM_SLOTS (1 << 19)
+// Number of generations of registered clauses which are remembered
+#define CCF_NUM_GENERATIONS 2
+// Number of consecutive slots a clause may occupy (four 64-byte cache lines).
+// Buckets are filled from the front, so a lookup stops at the first free slot.
+#define CCF_BUCKET_SIZE 16
+// Max. number of solvers which can be told apart (bits of the origins mask)
+#define CCF_MAX_SOLVERS 64
+
+/*
+Clause filter shared by all solvers of a process. In contrast to one ClauseFilter
+per solver, its memory use does not depend on the number of solvers. Each registered
+clause remembers the set of solvers which produced or received it (its origins) as
+a 64-bit mask, so an imported clause is only delivered to the solvers which have
+not seen it yet. Solver i is represented by bit i, so at most 64 solvers are supported.
+All methods may be called concurrently. Like any hash-based filter, it may
+(rarely) treat distinct clauses as equal. If all slots of a clause's bucket are
+occupied, the oldest clause of the bucket is replaced and forgotten. As long as
+no more than 1/10 of the slots of a generation are in use, this is very unlikely
+(probability < 1e-11 per bucket), and duplicates are detected exactly.
+*/
+class ConcurrentClauseFilter {
+
+private:
+	struct alignas(16) Slot {
+		std::atomic<uint64_t> key;
+		std::atomic<uint64_t> origins;
+	};
+	std::unique_ptr<Slot[]> _slots[CCF_NUM_GENERATIONS];
+	// Per bucket, the position of the slot to be replaced next if the bucket is full
+	std::unique_ptr<std::atomic<uint8_t>[]> _eviction_positions[CCF_NUM_GENERATIONS];
+	std::atomic_int _current_gen {0};
+	const int _max_clause_len;
+
+public:
+	ConcurrentClauseFilter(int maxClauseLen);
+
+	/**
+	 * Register a clause (glue int in front, except for unit clauses) produced
+	 * by the given solver. Return false if the clause has already been
+	 * registered before, otherwise return true.
+	 */
+	bool registerProducedClause(const int* begin, int size, int solverId);
+
+	/**
+	 * Register a clause (glue int in front, except for unit clauses) which
+	 * is imported into the solvers whose bits are set in allSolvers.
+	 * Return the bits of the solvers which have not seen the clause yet.
+	 */
+	uint64_t registerImportedClause(const int* begin, int size, uint64_t allSolvers);
+
+	static uint64_t getSolverBit(int solverId) {
+		assert(solverId >= 0 && solverId < CCF_MAX_SOLVERS);
+		return 1ULL << solverId;
+	}
+
+	/**
+	 * Clear the filter, i.e., return to its initial state.
+	 */
+	void clear();
+
+	/**
+	 * Forget the oldest generation of registered clauses
+	 * and begin a new generation.
+	 */
+	void age();
+
+private:
+	uint64_t getKey(const int* begin, int size);
+	Slot* find(uint64_t key, bool insert, bool& inserted);
+	void clearGeneration(int gen);
+};
+
+#endif
@@ -0,0 +1,42 @@
+
+#include <algorithm>
+#include <assert.h>
+
+#include "lbd_clause_selector.hpp"
+
+int LbdClauseSelector::writeSelection(std::vector<int>& buffer, size_t maxSize) {
+
+    // Rank clauses by LBD, then by length
+    std::stable_sort(_candidates.begin(), _candidates.end(), [](const Candidate& left, const Candidate& right) {
+        return left.lbd < right.lbd || (left.lbd == right.lbd && left.size < right.size);
+    });
+
+    // Reserve one counter per length bucket up to the largest clause
+    size_t maxClauseSize = 0;
+    for (const auto& cand : _candidates) maxClauseSize = std::max(maxClauseSize, (size_t)cand.size);
+    while (maxClauseSize > 0 && buffer.size() + maxClauseSize > maxSize) maxClauseSize--;
+    if (_selected_by_size.size() < maxClauseSize) _selected_by_size.resize(maxClauseSize);
+    for (size_t s = 0; s < maxClauseSize; s++) _selected_by_size[s].clear();
+
+    // Greedily pick the best clauses which still fit
+    size_t budget = maxSize - buffer.size() - maxClauseSize;
+    int numSelected = 0;
+    for (const auto& cand : _candidates) {
+        if ((size_t)cand.size > maxClauseSize || (size_t)cand.size > budget) continue;
+        _selected_by_size[cand.size-1].push_back(cand.begin);
+        budget -= cand.size;
+        numSelected++;
+    }
+
+    // Write length buckets, omitting trailing empty buckets
+    size_t sizeUntilLastClause = buffer.size();
+    for (size_t s = 0; s < maxClauseSize; s++) {
+        const auto& selected = _selected_by_size[s];
+        buffer.push_back(selected.size());
+        for (const int* begin : selected) buffer.insert(buffer.end(), begin, begin+s+1);
+        if (!selected.empty()) sizeUntilLastClause = buffer.size();
+    }
+    buffer.resize(sizeUntilLastClause);
+    assert(buffer.size() <= maxSize);
+    return numSelected;
+}
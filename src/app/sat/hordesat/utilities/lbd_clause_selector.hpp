@@ -0,0 +1,41 @@
+
+#ifndef DOMPASCH_MALLOB_LBD_CLAUSE_SELECTOR_HPP
+#define DOMPASCH_MALLOB_LBD_CLAUSE_SELECTOR_HPP
+
+#include <vector>
+#include <cstddef>
+
+/*
+Selects clauses for a size-limited clause buffer by their LBD (glue) first and 
+by their length second, instead of by their length only. 
+Clauses are given in the shape of the clause buffers (see ClauseDatabase::giveSelection):
+units as a single literal, other clauses as (glue+1) followed by the literals.
+The selection is written in the usual format of length buckets, so receivers 
+of a buffer do not depend on the selection policy.
+*/
+class LbdClauseSelector {
+
+private:
+    struct Candidate {
+        const int* begin;
+        int size; // #ints including glue
+        int lbd;
+    };
+    std::vector<Candidate> _candidates;
+    std::vector<std::vector<const int*>> _selected_by_size;
+
+public:
+    void clear() {_candidates.clear();}
+    void add(const int* begin, int size) {
+        _candidates.push_back(Candidate{begin, size, size == 1 ? 1 : begin[0]-1});
+    }
+    size_t getNumCandidates() const {return _candidates.size();}
+
+    // Appends the length buckets with the selected clauses to buffer 
+    // (which already contains the VIP clauses) such that buffer.size() <= maxSize.
+    // Clauses of equal LBD and length are selected in the order they were added.
+    // Returns the number of selected clauses.
+    int writeSelection(std::vector<int>& buffer, size_t maxSize);
+};
+
+#endif
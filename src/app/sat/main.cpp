@@ -17,6 +17,7 @@
 #include "util/sys/proc.hpp"
 
 #include "app/sat/horde_process_adapter.hpp"
+#include "app/sat/sat_process_pool.hpp"
 #include "hordesat/horde.hpp"
 
 #ifndef MALLOB_VERSION
@@ -52,9 +53,9 @@ void runSolverEngine(const Logger& log, const Parameters& programParams) {
     int* aPtr = (int*) accessMemory(log, aId, aSize);
 
     // Set up export and import buffers for clause exchanges
-    int maxExportBufferSize = programParams.getIntParam("cbbs") * sizeof(int);
+    int maxExportBufferSize = programParams.getIntParam("exportbufsize");
     int* exportBuffer = (int*) accessMemory(log, shmemId + ".clauseexport", maxExportBufferSize);
-    int maxImportBufferSize = programParams.getIntParam("cbbs") * sizeof(int) * programParams.getIntParam("mpisize");
+    int maxImportBufferSize = programParams.getIntParam("importbufsize");
     int* importBuffer = (int*) accessMemory(log, shmemId + ".clauseimport", maxImportBufferSize);
 
     // Signal initialization to parent
@@ -62,6 +63,7 @@ void runSolverEngine(const Logger& log, const Parameters& programParams) {
     
     // Prepare solver
     HordeLib hlib(programParams, log.copy("H", "H"));
+    hlib.setSolutionCallback([hsm]() {hsm->childWakeup.notify();});
     hlib.beginSolving(fSize/sizeof(int), fPtr, aSize/sizeof(int), aPtr);
     bool interrupted = false;
     std::vector<int> solutionVec;
@@ -71,14 +73,16 @@ void runSolverEngine(const Logger& log, const Parameters& programParams) {
     int solutionShmemSize = 0;
 
     // Main loop
+    int seenWakeups = hsm->childWakeup.current();
     while (true) {
 
-        // Wait until something happens
-        // (can be interrupted by Fork::wakeUp(hsm->childPid))
+        // Wait until something happens (instruction from parent or result from solvers).
+        // As long as the solvers are not fully initialized, the state is checked periodically.
         float time = Timer::elapsedSeconds();
-        int sleepStatus = usleep(1000 /*1 millisecond*/);
+        hsm->childWakeup.wait(seenWakeups, hsm->isInitialized ? -1 : 1000 /*1 millisecond*/);
+        seenWakeups = hsm->childWakeup.current();
         time = Timer::elapsedSeconds() - time;
-        if (sleepStatus != 0) log.log(V5_DEBG, "Woken up after %i us\n", (int) (1000*1000*time));
+        log.log(V5_DEBG, "Woken up after %i us\n", (int) (1000*1000*time));
 
         // Terminate
         if (hsm->doTerminate) {
@@ -87,17 +91,20 @@ void runSolverEngine(const Logger& log, const Parameters& programParams) {
             break;
         }
 
+        // Each instruction X is handled once per request number reqX;
+        // storing it to ackX responds to the parent (see HordeProcessAdapter::issue)
+        int req;
+
         // Interrupt solvers
-        if (hsm->doInterrupt && !hsm->didInterrupt) {
+        if ((req = hsm->reqInterrupt.load(std::memory_order_acquire)) != hsm->ackInterrupt) {
             log.log(V5_DEBG, "DO interrupt\n");
             hlib.interrupt();
-            hsm->didInterrupt = true;
+            hsm->ackInterrupt.store(req, std::memory_order_release);
             interrupted = true;
         }
-        if (!hsm->doInterrupt) hsm->didInterrupt = false;
 
         // Dump stats
-        if (!interrupted && hsm->doDumpStats && !hsm->didDumpStats) {
+        if (!interrupted && (req = hsm->reqDumpStats.load(std::memory_order_acquire)) != hsm->ackDumpStats) {
             log.log(V5_DEBG, "DO dump stats\n");
             
             hlib.dumpStats(/*final=*/false);
@@ -120,35 +127,31 @@ void runSolverEngine(const Logger& log, const Parameters& programParams) {
                 }
             }
 
-            hsm->didDumpStats = true;
+            hsm->ackDumpStats.store(req, std::memory_order_release);
         }
-        if (!hsm->doDumpStats) hsm->didDumpStats = false;
 
         // Update role
-        if (hsm->doUpdateRole && !hsm->didUpdateRole) {
+        if ((req = hsm->reqUpdateRole.load(std::memory_order_acquire)) != hsm->ackUpdateRole) {
             log.log(V5_DEBG, "DO update role\n");
             hlib.updateRole(hsm->portfolioRank, hsm->portfolioSize);
-            hsm->didUpdateRole = true;
+            hsm->ackUpdateRole.store(req, std::memory_order_release);
         }
-        if (!hsm->doUpdateRole) hsm->didUpdateRole = false;
 
         // Check if clauses should be exported
-        if (!interrupted && hsm->doExport && !hsm->didExport) {
+        if (!interrupted && (req = hsm->reqExport.load(std::memory_order_acquire)) != hsm->ackExport) {
             log.log(V5_DEBG, "DO export clauses\n");
             // Collect local clauses, put into shared memory
             hsm->exportBufferTrueSize = hlib.prepareSharing(exportBuffer, hsm->exportBufferMaxSize);
-            hsm->didExport = true;
+            hsm->ackExport.store(req, std::memory_order_release);
         }
-        if (!hsm->doExport) hsm->didExport = false;
 
         // Check if clauses should be imported
-        if (!interrupted && hsm->doImport && !hsm->didImport) {
+        if (!interrupted && (req = hsm->reqImport.load(std::memory_order_acquire)) != hsm->ackImport) {
             log.log(V5_DEBG, "DO import clauses\n");
             // Write imported clauses from shared memory into vector
             hlib.digestSharing(importBuffer, hsm->importBufferSize);
-            hsm->didImport = true;
+            hsm->ackImport.store(req, std::memory_order_release);
         }
-        if (!hsm->doImport) hsm->didImport = false;
 
         // Check initialization state
         if (!interrupted && !hsm->isInitialized && hlib.isFullyInitialized()) {
@@ -205,15 +208,19 @@ int main(int argc, char *argv[]) {
     int rankOfParent = params.getIntParam("mpirank");
 
     Logger::init(rankOfParent, params.getIntParam("v"), params.isNotNull("colors"), 
-            /*quiet=*/params.isNotNull("q"), /*cPrefix=*/params.isNotNull("mono"), params.getParam("log"));
+            /*quiet=*/params.isNotNull("q"), /*cPrefix=*/params.isNotNull("mono"), params.getParam("log"), 
+            /*asynchronous=*/params.isNotNull("alog"));
+
+    // Initialize signal handlers
+    Process::init(rankOfParent, /*leafProcess=*/true);
+
+    // Pre-spawned process: wait until some job is assigned
+    if (params.isSet("poolslot")) SatProcessPool::awaitBinding(params);
     
     auto log = getLog(params);
     pid_t pid = Proc::getPid();
     log.log(V3_VERB, "mallob SAT engine %s pid=%lu\n", MALLOB_VERSION, pid);
 
-    // Initialize signal handlers
-    Process::init(rankOfParent, /*leafProcess=*/true);
-
     try {
         // Launch program
         runSolverEngine(log, params);
@@ -0,0 +1,209 @@
+
+#include <assert.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "sat_process_pool.hpp"
+
+#include "util/logger.hpp"
+#include "util/sys/shared_memory.hpp"
+#include "util/sys/process.hpp"
+#include "util/sys/proc.hpp"
+#include "util/sys/timer.hpp"
+
+// Time (seconds) after which a bound process which did not acknowledge
+// its binding is not waited for any longer to re-use its control block
+#define BINDING_TIMEOUT 1.0
+
+Parameters SatProcessPool::_params;
+std::vector<SatProcessPool::Slot> SatProcessPool::_slots;
+Mutex SatProcessPool::_mutex;
+
+void SatProcessPool::init(const Parameters& params, int rank) {
+
+    int poolSize = params.getIntParam("pps");
+    if (poolSize <= 0) return;
+
+    auto lock = _mutex.getLock();
+    _params = params;
+    _params["mpirank"] = std::to_string(rank);
+    _params["starttime"] = std::to_string(Timer::getStartTime());
+
+    for (int i = 0; i < poolSize; i++) {
+        Slot slot;
+        slot.shmemId = getShmemId(Proc::getPid(), _params["mpirank"], i);
+        void* shmem = SharedMemory::create(slot.shmemId, sizeof(SatProcessSlot));
+        slot.block = new ((char*)shmem) SatProcessSlot();
+        _slots.push_back(slot);
+        spawn(i);
+    }
+    log(V3_VERB, "Pre-spawned %i SAT processes\n", poolSize);
+}
+
+pid_t SatProcessPool::bind(const Parameters& jobParams) {
+
+    // Serialize arguments
+    const char* execName = "mallob_sat_process";
+    char* const* argv = jobParams.asCArgs(execName);
+    std::vector<char> args;
+    int i = 1;
+    while (argv[i] != nullptr) {
+        args.insert(args.end(), argv[i], argv[i] + strlen(argv[i]) + 1);
+        free(argv[i++]);
+    }
+    delete[] argv;
+    if (args.size() > SAT_PROCESS_SLOT_ARGS_SIZE) {
+        log(V1_WARN, "[WARN] Arguments of size %lu do not fit into SAT process slot\n", args.size());
+        return -1;
+    }
+
+    // Never wait for the pool: if it is busy (e.g., refilling), fall back to forking
+    if (!_mutex.tryLock()) return -1;
+    pid_t boundPid = -1;
+    for (auto& slot : _slots) {
+        pid_t pid = slot.pid;
+        if (pid <= 0 || slot.bound) continue;
+        if (Process::didChildExit(pid)) {
+            log(V1_WARN, "[WARN] Pooled SAT process pid=%i exited\n", pid);
+            slot.pid = -1; // to be replaced by refill()
+            continue;
+        }
+        // Only bind processes which already wait for a binding
+        SatProcessSlot* block = slot.block;
+        if (!block->isWaiting) continue;
+
+        // Hand over arguments to the waiting process without awaiting its acknowledgement
+        memcpy(block->args, args.data(), args.size());
+        block->argsSize = args.size();
+        block->isBound = true;
+        block->childWakeup.notify();
+        slot.bound = true;
+        slot.bindTime = Timer::elapsedSeconds();
+        log(V5_DEBG, "Bound pooled SAT process pid=%i\n", pid);
+        boundPid = pid;
+        break;
+    }
+    _mutex.unlock();
+    return boundPid;
+}
+
+void SatProcessPool::refill() {
+
+    if (!_mutex.tryLock()) return;
+
+    for (size_t slotIdx = 0; slotIdx < _slots.size(); slotIdx++) {
+        auto& slot = _slots[slotIdx];
+        if (slot.bound) {
+            if (!slot.block->isAcknowledged) {
+                if (Timer::elapsedSeconds() - slot.bindTime <= BINDING_TIMEOUT) continue;
+                // The bound process may still read its arguments later:
+                // give up on this control block and continue with a new one.
+                // (The process now belongs to its job and is not reaped here.)
+                log(V1_WARN, "[WARN] Pooled SAT process pid=%i did not acknowledge binding\n", slot.pid);
+                renewBlock(slotIdx);
+            }
+        } else if (slot.pid > 0) {
+            // Idle process: keep it as long as it is alive
+            if (!Process::didChildExit(slot.pid)) continue;
+            log(V1_WARN, "[WARN] Pooled SAT process pid=%i exited\n", slot.pid);
+            slot.pid = -1;
+        }
+
+        // Replace the bound or exited process of this slot
+        spawn(slotIdx);
+        break;
+    }
+    _mutex.unlock();
+}
+
+void SatProcessPool::release() {
+    auto lock = _mutex.getLock();
+    for (auto& slot : _slots) {
+        SharedMemory::free(slot.shmemId, (char*)slot.block, sizeof(SatProcessSlot));
+    }
+    _slots.clear();
+}
+
+void SatProcessPool::awaitBinding(Parameters& params) {
+
+    std::string shmemId = getShmemId(Proc::getParentPid(), params.getParam("mpirank"),
+            params.getIntParam("poolslot"));
+    SatProcessSlot* block = (SatProcessSlot*) SharedMemory::access(shmemId, sizeof(SatProcessSlot));
+    if (block == nullptr) {
+        log(V0_CRIT, "Could not access shmem %s! Aborting.\n", shmemId.c_str());
+        raise(SIGTERM);
+    }
+
+    // Sleep until some job is bound to this process
+    int seenWakeups = block->childWakeup.current();
+    block->isWaiting = true;
+    while (!block->isBound) {
+        block->childWakeup.wait(seenWakeups);
+        seenWakeups = block->childWakeup.current();
+    }
+
+    // Copy arguments, then acknowledge: the parent may re-use the slot right away
+    std::vector<char> args(block->args, block->args + block->argsSize);
+    block->isAcknowledged = true;
+    block->parentWakeup.notify();
+    munmap(block, sizeof(SatProcessSlot));
+
+    std::vector<char*> argv(1, nullptr);
+    for (size_t pos = 0; pos < args.size(); pos += strlen(args.data()+pos) + 1) {
+        argv.push_back(args.data()+pos);
+    }
+    Parameters jobParams;
+    jobParams.init(argv.size(), argv.data());
+    params = jobParams;
+}
+
+void SatProcessPool::renewBlock(int slotIdx) {
+    // The old block stays valid for processes which have mapped it
+    auto& slot = _slots[slotIdx];
+    SharedMemory::free(slot.shmemId, (char*)slot.block, sizeof(SatProcessSlot));
+    void* shmem = SharedMemory::create(slot.shmemId, sizeof(SatProcessSlot));
+    slot.block = new ((char*)shmem) SatProcessSlot();
+}
+
+std::string SatProcessPool::getShmemId(pid_t parentPid, const std::string& rank, int slotIdx) {
+    return "/edu.kit.iti.mallob." + std::to_string(parentPid) + "." + rank + ".pool." + std::to_string(slotIdx);
+}
+
+void SatProcessPool::spawn(int slotIdx) {
+
+    auto& slot = _slots[slotIdx];
+    SatProcessSlot* block = slot.block;
+    block->childWakeup.reset();
+    block->parentWakeup.reset();
+    block->isWaiting = false;
+    block->isBound = false;
+    block->isAcknowledged = false;
+    block->argsSize = 0;
+    slot.bound = false;
+    slot.pid = -1;
+
+    // Assemble c-style program arguments
+    Parameters params(_params);
+    params["poolslot"] = std::to_string(slotIdx);
+    const char* execName = "mallob_sat_process";
+    char* const* argv = params.asCArgs(execName);
+
+    // FORK: Create a child process
+    pid_t res = Process::createChild();
+    if (res > 0) {
+        // [parent process]
+        slot.pid = res;
+        int i = 1;
+        while (argv[i] != nullptr) free(argv[i++]);
+        delete[] argv;
+        return;
+    }
+
+    // [child process]
+    // Execute the SAT process, which will wait for a binding.
+    execvp("mallob_sat_process", argv);
+
+    abort(); // if this is reached, something went wrong with execvp
+}
@@ -0,0 +1,86 @@
+
+#ifndef DOMPASCH_MALLOB_SAT_PROCESS_POOL_HPP
+#define DOMPASCH_MALLOB_SAT_PROCESS_POOL_HPP
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+#include "util/params.hpp"
+#include "util/sys/threading.hpp"
+#include "util/sys/wakeup_event.hpp"
+
+#define SAT_PROCESS_SLOT_ARGS_SIZE 65536
+
+/*
+Control block in shared memory through which an idle pooled SAT process
+receives the program arguments of the job it is bound to.
+*/
+struct SatProcessSlot {
+
+    // Notified by the parent when a job is bound to the slot
+    WakeupEvent childWakeup;
+    // Notified by the child when it has read the job's arguments
+    WakeupEvent parentWakeup;
+
+    // Set by the child as soon as it waits for a binding
+    std::atomic_bool isWaiting;
+    std::atomic_bool isBound;
+    std::atomic_bool isAcknowledged;
+
+    // Sequence of zero-terminated "-key=value" arguments
+    int argsSize;
+    char args[SAT_PROCESS_SLOT_ARGS_SIZE];
+};
+
+/*
+Pool of pre-spawned, idle mallob_sat_process instances (appmode "fork").
+Each process of the pool has already been forked and exec'd and waits on its
+own control block; starting a job then only requires handing over the job's
+arguments. Binding never waits: if no pooled process is ready, the caller falls
+back to forking a process itself. A bound process is replaced by a freshly
+spawned one from refill() (called periodically by the worker's main thread)
+as soon as it has acknowledged the binding. Methods of the parent side are
+thread-safe.
+*/
+class SatProcessPool {
+
+private:
+    struct Slot {
+        std::string shmemId;
+        SatProcessSlot* block = nullptr;
+        pid_t pid = -1;
+        // Arguments have been handed over to the process
+        bool bound = false;
+        float bindTime = 0;
+    };
+
+    static Parameters _params;
+    static std::vector<Slot> _slots;
+    static Mutex _mutex;
+
+public:
+    // [parent] Pre-spawns the configured number of SAT processes.
+    static void init(const Parameters& params, int rank);
+    // [parent] Binds an idle pooled process to the job with the provided parameters.
+    // Returns the PID of the bound process, or -1 if no pooled process is ready.
+    // Does not block.
+    static pid_t bind(const Parameters& jobParams);
+    // [parent] Replaces bound and exited processes with fresh ones.
+    // Does not block; spawns at most one process per call.
+    static void refill();
+    // [parent] Frees the control blocks. Pooled processes are terminated by Process::terminateAll().
+    static void release();
+
+    // [child] Blocks until a job is bound to this pooled process, then
+    // replaces the pool-level parameters with the job's parameters.
+    static void awaitBinding(Parameters& params);
+
+private:
+    static std::string getShmemId(pid_t parentPid, const std::string& rank, int slotIdx);
+    static void spawn(int slotIdx);
+    static void renewBlock(int slotIdx);
+};
+
+#endif
@@ -36,7 +36,6 @@ private:
     Mutex _solver_lock;
 
     float _time_of_start_solving = 0;
-    float _time_of_last_comm = 0;
     float _job_comm_period;
 
 public:
@@ -29,7 +29,7 @@ bool EventDrivenBalancer::beginBalancing(robin_hood::unordered_map<int, Job*>& j
             
             // Job might have been active just before: Signal its termination
             Event ev({id, /*epoch=*/INT_MAX, /*demand=*/0, /*priority=*/0});
-            if (_states.getEntries().count(id) || _diffs.getEntries().count(id)) {
+            if (_states.contains(id) || _diffs.contains(id)) {
                 // Job is registered, possibly with non-zero demand: try to insert into diffs map
                 bool inserted = _diffs.insertIfNovel(ev);
                 if (inserted) {
@@ -52,9 +52,9 @@ bool EventDrivenBalancer::beginBalancing(robin_hood::unordered_map<int, Job*>& j
             int epoch = _job_epochs[id];
             int demand = std::max(1, getDemand(*job));
             Event ev({id, epoch, demand, job->getPriority()});
-            if (!_states.getEntries().count(id) 
-                    || ev.demand != _states.getEntries().at(id).demand 
-                    || ev.priority != _states.getEntries().at(id).priority) {
+            if (!_states.contains(id) 
+                    || ev.demand != _states.at(id).demand 
+                    || ev.priority != _states.at(id).priority) {
                 // Not contained yet in state: try to insert into diffs map
                 bool inserted = _diffs.insertIfNovel(ev);
                 if (inserted) {
@@ -282,23 +282,15 @@ bool EventDrivenBalancer::isLeaf(int rank, bool reversedTree) {
     return rank % 2 == (reversedTree ? 0 : 1);
 }
 
-int EventDrivenBalancer::getNewDemand(int jobId) {
-    return _states.getEntries().at(jobId).demand;
-}
-
-float EventDrivenBalancer::getPriority(int jobId) {
-    return _states.getEntries().at(jobId).priority;
-}
-
 robin_hood::unordered_map<int, int> EventDrivenBalancer::getBalancingResult() {
 
     float now = Timer::elapsedSeconds();
     
     // Mark terminated jobs
-    for (const auto& [jobId, ev] : _states.getEntries()) {
+    for (const auto& ev : _states.getEntries()) {
         if (ev.epoch == INT_MAX) {
-            log(V3_VERB, "BLC mark termination of %i\n", jobId);
-            _time_of_termination[jobId] = now;
+            log(V3_VERB, "BLC mark termination of %i\n", ev.jobId);
+            _time_of_termination[ev.jobId] = now;
         }
     }
     // Force remove any entries associated with terminated jobs
@@ -313,13 +305,31 @@ robin_hood::unordered_map<int, int> EventDrivenBalancer::getBalancingResult() {
     int rank = MyMpi::rank(MPI_COMM_WORLD);
     int verb = rank == 0 ? V4_VVER : V5_DEBG;  
 
+    // Each worker offers a slot to each of up to ajpw active jobs
+    int numSlots = MyMpi::size(_comm) * std::max(1, _params.getIntParam("ajpw"));
+    auto allVolumes = computeVolumes(_states, numSlots, _load_factor, 
+            _params.getParam("r"), _balancing_epoch, verb);
+
+    // Only remember job assignments that are of a local job
+    robin_hood::unordered_map<int, int> volumes;
+    for (const auto& [jobId, job] : _jobs_being_balanced) {
+        auto it = allVolumes.find(jobId);
+        if (it != allVolumes.end() && it->second >= 1) volumes[jobId] = it->second;
+    }
+
+    return volumes;
+}
+
+robin_hood::unordered_map<int, int> EventDrivenBalancer::computeVolumes(const EventMap& states, int numSlots, 
+        float loadFactor, const std::string& roundingMode, int epoch, int verb) {
+
     robin_hood::unordered_map<int, int> volumes;
 
     // 1. Calculate aggregated demand of all jobs
     std::string assignMsg = " ";
     float aggregatedDemand = 0;
     int numJobs = 0;
-    for (const auto& [key, ev] : _states.getEntries()) {
+    for (const auto& ev : states.getEntries()) {
         assert(ev.demand >= 0);
         if (ev.demand == 0) continue;
         
@@ -329,15 +339,14 @@ robin_hood::unordered_map<int, int> EventDrivenBalancer::getBalancingResult() {
         aggregatedDemand += (ev.demand-1) * ev.priority;
         assignMsg += "#" + std::to_string(ev.jobId) + "=" + std::to_string(ev.demand) + " ";
     }
-    log(verb, "BLC e=%i demand={%s}\n", _balancing_epoch, assignMsg.c_str());
-    float totalAvailVolume = MyMpi::size(_comm) * _load_factor - numJobs;
+    log(verb, "BLC e=%i demand={%s}\n", epoch, assignMsg.c_str());
+    float totalAvailVolume = numSlots * loadFactor - numJobs;
 
     // 2a. Bail out if the elementary demand of each job cannot be met
     if (totalAvailVolume < 0) {
         log(verb, "BLC Too many jobs: bailing out, assigning 1 to each job\n");
-        for (const auto& [jobId, job] : _jobs_being_balanced) {
-            if (_states.getEntries().count(jobId) && getNewDemand(jobId) > 0)
-                volumes[jobId] = 1;
+        for (const auto& ev : states.getEntries()) {
+            if (ev.demand > 0) volumes[ev.jobId] = 1;
         }
         return volumes;
     }
@@ -346,8 +355,9 @@ robin_hood::unordered_map<int, int> EventDrivenBalancer::getBalancingResult() {
     robin_hood::unordered_map<int, double> assignments;
     float assignedResources = 0;
     std::map<float, float, std::less<float>> demandedResources;
-    for (const auto& [jobId, ev] : _states.getEntries()) {
+    for (const auto& ev : states.getEntries()) {
         if (ev.demand == 0) continue;
+        int jobId = ev.jobId;
 
         double initialMetRatio = totalAvailVolume * ev.priority / aggregatedDemand;
         // job demand minus "atomic" demand that is met by default
@@ -364,24 +374,25 @@ robin_hood::unordered_map<int, int> EventDrivenBalancer::getBalancingResult() {
         assert(a >= 0 || a <= totalAvailVolume || log_return_false("Invalid assignment %.3f for job %i!\n", a, jobId));
         assignMsg += "#" + std::to_string(jobId) + "=" + Logger::floatToStr(a, 2) + " ";
     }
-    log(verb, "BLC e=%i init_assign={%s}\n", _balancing_epoch, assignMsg.c_str());
+    log(verb, "BLC e=%i init_assign={%s}\n", epoch, assignMsg.c_str());
 
     // 3. Calculate final floating-point assignments for all jobs
 
     log(verb, "BLC e=%i init_assigned=%.3f\n", 
-        _balancing_epoch, assignedResources);
+        epoch, assignedResources);
     
     // Atomic job assignments are already subtracted from _total_avail_volume
     // and are not part of the all-reduced assignedResources either
     float remainingResources = totalAvailVolume - assignedResources;
     if (remainingResources < 0.1) remainingResources = 0; // too low a remainder to make a difference
-    log(verb, "BLC e=%i remaining=%.3f\n", _balancing_epoch, remainingResources);
+    log(verb, "BLC e=%i remaining=%.3f\n", epoch, remainingResources);
 
-    for (const auto& [jobId, ev] : _states.getEntries()) {
+    for (const auto& ev : states.getEntries()) {
         if (ev.demand <= 1) continue;
 
-        int demand = getNewDemand(jobId);
-        float priority = getPriority(jobId);
+        int jobId = ev.jobId;
+        int demand = ev.demand;
+        float priority = ev.priority;
         float prevPriority = -1;
         for (const auto& entry : demandedResources) {
             if (entry.first == priority) break;
@@ -410,87 +421,40 @@ robin_hood::unordered_map<int, int> EventDrivenBalancer::getBalancingResult() {
     for (const auto& e : assignments) {
         assignMsg += "#" + std::to_string(e.first) + "=" + Logger::floatToStr(e.second, 2) + " ";
     }
-    log(verb, "BLC e=%i adj_assign={%s}\n", _balancing_epoch, assignMsg.c_str());
+    log(verb, "BLC e=%i adj_assign={%s}\n", epoch, assignMsg.c_str());
 
     // 4. Round job assignments
     robin_hood::unordered_map<int, int> allVolumes;
-    if (_params.getParam("r") == ROUNDING_FLOOR) {
+    if (roundingMode == ROUNDING_FLOOR) {
         // Round by flooring
-        for (const auto& entry : _states.getEntries()) {
-            allVolumes[entry.first] = std::floor(assignments[entry.first]);
+        for (const auto& ev : states.getEntries()) {
+            allVolumes[ev.jobId] = std::floor(assignments[ev.jobId]);
         }
-    } else if (_params.getParam("r") == ROUNDING_PROBABILISTIC) {
+    } else if (roundingMode == ROUNDING_PROBABILISTIC) {
         // Round probabilistically
-        for (const auto& entry : _states.getEntries()) {
-            allVolumes[entry.first] = Random::roundProbabilistically(assignments[entry.first]);
+        for (const auto& ev : states.getEntries()) {
+            allVolumes[ev.jobId] = Random::roundProbabilistically(assignments[ev.jobId]);
         }
-    } else if (_params.getParam("r") == ROUNDING_BISECTION) {
+    } else if (roundingMode == ROUNDING_BISECTION) {
 
         // Calculate optimal rounding by bisection
 
-        SortedDoubleSequence remainders;
-        for (const auto& [jobId, ev] : _states.getEntries()) {
-            double remainder = assignments[jobId] - (int)assignments[jobId];
-            if (remainder > 0 && remainder < 1) remainders.add(remainder);
+        // Each job of the state takes part in the rounding
+        for (const auto& ev : states.getEntries()) {
+            if (!assignments.count(ev.jobId)) assignments[ev.jobId] = 0;
         }
-        int lower = 0, upper = remainders.size();
-        int idx = (lower+upper)/2;
-        int iterations = 0;
-        float lastUtilization = -1;
-
-        int bestRemainderIdx = -1;
-        float bestPenalty;
-        float bestUtilization;
-
-        while (true) {
-            int utilization = 0;
-            if (idx <= remainders.size()) {
-                // Round your local assignments and calculate utilization sum
-                volumes = Rounding::getRoundedAssignments(idx, utilization, remainders, assignments);
-            }
+        SortedDoubleSequence remainders;
+        std::vector<int> utilizations;
+        Rounding::getUtilizationsPerRemainder(assignments, remainders, utilizations);
 
-            // Store result, if it is the best one so far
-            float p = Rounding::penalty((float)utilization / MyMpi::size(_comm), _load_factor);
-            if (bestRemainderIdx == -1 || p < bestPenalty) {
-                bestPenalty = p;
-                bestRemainderIdx = idx;
-                bestUtilization = utilization;
-            }
+        auto result = Rounding::bisect(remainders, utilizations, numSlots, loadFactor, epoch, verb);
+        int sum = 0;
+        allVolumes = Rounding::getRoundedAssignments(result.remainderIdx, sum, remainders, assignments);
 
-            // Log iteration
-            if (!remainders.isEmpty() && idx <= remainders.size()) {
-                double remainder = (idx < remainders.size() ? remainders[idx] : 1.0);
-                log(verb, "BLC e=%i RND it=%i [%i,%i]=>%i rmd=%.3f util=%.2f pen=%.2f\n", 
-                                _balancing_epoch, iterations, lower, upper, idx,
-                                remainder, (float)utilization, p);
-            }
-
-            // Termination?
-            if (utilization == lastUtilization) { // Utilization unchanged?
-                // Finished!
-                int sum = 0;
-                allVolumes = Rounding::getRoundedAssignments(bestRemainderIdx, sum, remainders, assignments);
-
-                double remainder = (bestRemainderIdx < remainders.size() ? remainders[bestRemainderIdx] : 1.0);
-                log(verb-1, "BLC e=%i DONE n=%i its=%i rmd=%.3f util=%.2f pen=%.2f\n", 
-                            _balancing_epoch, assignments.size(), iterations, remainder, bestUtilization, bestPenalty);
-                break;
-
-            } else if (lower < upper) {
-                if (utilization < _load_factor*MyMpi::size(_comm)) {
-                    // Too few resources utilized
-                    upper = idx-1;
-                }
-                if (utilization > _load_factor*MyMpi::size(_comm)) {
-                    // Too many resources utilized
-                    lower = idx+1;
-                }
-                idx = (lower+upper)/2;
-            }
-            
-            lastUtilization = utilization;
-            iterations++;
-        }
+        double remainder = (result.remainderIdx < remainders.size() ? remainders[result.remainderIdx] : 1.0);
+        log(verb-1, "BLC e=%i DONE n=%i its=%i rmd=%.3f util=%.2f pen=%.2f\n", 
+                    epoch, assignments.size(), result.iterations, remainder, 
+                    result.utilization, result.penalty);
     }
 
     // Log final assignments
@@ -502,13 +466,7 @@ robin_hood::unordered_map<int, int> EventDrivenBalancer::getBalancingResult() {
     }
     log(verb-1, "BLC assigned%s sum=%i\n", msg.c_str(), sum);
 
-    // 5. Only remember job assignments that are of a local job
-    volumes.clear();
-    for (const auto& [jobId, job] : _jobs_being_balanced) {
-        if (allVolumes[jobId] >= 1) volumes[jobId] = allVolumes[jobId];
-    }
-
-    return volumes;
+    return allVolumes;
 }
 
 void EventDrivenBalancer::forget(int jobId) {
@@ -5,6 +5,8 @@
 #include <utility>
 #include <map>
 #include <list>
+#include <vector>
+#include <algorithm>
 
 #include "balancing/balancer.hpp"
 #include "data/reduceable.hpp"
@@ -33,77 +35,56 @@ struct Event {
 class EventMap : public Reduceable {
 
 private:
-    std::map<int, Event> _map;
+    // Events sorted by job ID. The serialized form of an event map is
+    // exactly the memory of this vector.
+    std::vector<Event> _events;
 
-    const int _size_per_event = 3*sizeof(int)+sizeof(float);
+    static constexpr int _size_per_event = 3*sizeof(int)+sizeof(float);
+    static_assert(sizeof(Event) == _size_per_event, "Event must not contain padding");
 
 public:
     virtual std::vector<uint8_t> serialize() const override {
-        std::vector<uint8_t> result(_map.size() * _size_per_event);
-        int i = 0, n;
-        for (const auto& entry : _map) {
-            n = sizeof(int); memcpy(result.data()+i, &entry.second.jobId, n); i += n;
-            n = sizeof(int); memcpy(result.data()+i, &entry.second.epoch, n); i += n;
-            n = sizeof(int); memcpy(result.data()+i, &entry.second.demand, n); i += n;
-            n = sizeof(float); memcpy(result.data()+i, &entry.second.priority, n); i += n;
-        }
+        std::vector<uint8_t> result(_events.size() * _size_per_event);
+        if (!_events.empty()) memcpy(result.data(), _events.data(), result.size());
         return result;
     }
     virtual EventMap& deserialize(const std::vector<uint8_t>& packed) override {
-        _map.clear();
+        _events.clear();
         if (packed.size() <= sizeof(int)) return *this;
         assert(packed.empty() || packed.size() % _size_per_event == 0);
-        int numEvents = packed.size() / _size_per_event;
-        int i = 0, n;
-        for (int ev = 0; ev < numEvents; ev++) {
-            Event newEvent;
-            n = sizeof(int); memcpy(&newEvent.jobId, packed.data()+i, n); i += n;
-            n = sizeof(int); memcpy(&newEvent.epoch, packed.data()+i, n); i += n;
-            n = sizeof(int); memcpy(&newEvent.demand, packed.data()+i, n); i += n;
-            n = sizeof(float); memcpy(&newEvent.priority, packed.data()+i, n); i += n;
-            _map[newEvent.jobId] = newEvent;
-        }
+        _events.resize(packed.size() / _size_per_event);
+        memcpy(_events.data(), packed.data(), packed.size());
         return *this;
     }
     virtual void merge(const Reduceable& other) {
 
-        EventMap& otherEventMap = (EventMap&) other;
-        auto it = _map.begin();
-        auto otherIt = otherEventMap._map.begin();
-        std::map<int, Event> newMap;
+        const EventMap& otherEventMap = (const EventMap&) other;
+        const auto& otherEvents = otherEventMap._events;
+        std::vector<Event> newEvents;
+        newEvents.reserve(_events.size() + otherEvents.size());
 
         // Iterate over both event maps (sorted by job ID) simultaneously
-        while (it != _map.end() || otherIt != otherEventMap._map.end()) {
-
-            if (it != _map.end() && otherIt != otherEventMap._map.end()) {
-                // Both have an element left: compare them
-                const auto& pair = *it;
-                const auto& otherPair = *otherIt;
-                if (pair.first == otherPair.first) {
-                    // Same ID -- take newer event, forget other one
-                    newMap[pair.first] = (pair.second.dominates(otherPair.second) ? pair.second : otherPair.second);
-                    it++; otherIt++;
-                } else {
-                    // Different ID -- insert lower one
-                    if (pair.first < otherPair.first) {
-                        newMap[pair.first] = pair.second;
-                        it++;
-                    } else {
-                        newMap[otherPair.first] = otherPair.second;
-                        otherIt++;
-                    }
-                }
-            } else if (it != _map.end()) {
-                // only "it" has an element left: insert
-                newMap[it->first] = it->second;
-                it++;
+        size_t i = 0, j = 0;
+        while (i < _events.size() && j < otherEvents.size()) {
+            const auto& ev = _events[i];
+            const auto& otherEv = otherEvents[j];
+            if (ev.jobId == otherEv.jobId) {
+                // Same ID -- take newer event, forget other one
+                newEvents.push_back(ev.dominates(otherEv) ? ev : otherEv);
+                i++; j++;
+            } else if (ev.jobId < otherEv.jobId) {
+                // Different ID -- insert lower one
+                newEvents.push_back(ev);
+                i++;
             } else {
-                // only "otherIt" has an element left: insert
-                newMap[otherIt->first] = otherIt->second;
-                otherIt++;
+                newEvents.push_back(otherEv);
+                j++;
             }
         }
-        _map = newMap;
+        // Insert the remaining elements of either map
+        newEvents.insert(newEvents.end(), _events.begin()+i, _events.end());
+        newEvents.insert(newEvents.end(), otherEvents.begin()+j, otherEvents.end());
+        _events = std::move(newEvents);
     }
     virtual std::unique_ptr<Reduceable> getDeserialized(const std::vector<uint8_t>& packed) const {
         auto result = std::unique_ptr<Reduceable>(new EventMap());
@@ -111,63 +92,103 @@ public:
         return result;
     }
     virtual bool isEmpty() const {
-        return _map.empty();
+        return _events.empty();
     }
 
     bool insertIfNovel(const Event& ev) {
         if (ev.epoch < 0) return false; // Old, terminated job
-        // Update map if no such job entry yet or existing entry is older
-        if (!_map.count(ev.jobId) || (ev.dominates(_map[ev.jobId]) && 
-                (ev.demand != _map[ev.jobId].demand || ev.priority != _map[ev.jobId].priority)
-            )) {
-            _map[ev.jobId] = ev;
+        auto it = find(ev.jobId);
+        if (it == _events.end() || it->jobId != ev.jobId) {
+            // No such job entry yet
+            _events.insert(it, ev);
+            return true;
+        }
+        // Update entry if the existing one is older
+        if (isNovel(ev, *it)) {
+            *it = ev;
             return true;
         }
         return false;
     }
-    const std::map<int, Event>& getEntries() const {
-        return _map;
+    const std::vector<Event>& getEntries() const {
+        return _events;
+    }
+    bool contains(int jobId) const {
+        auto it = find(jobId);
+        return it != _events.end() && it->jobId == jobId;
+    }
+    const Event& at(int jobId) const {
+        auto it = find(jobId);
+        assert(it != _events.end() && it->jobId == jobId);
+        return *it;
     }
     void filterBy(const EventMap& otherMap) {
-        std::vector<int> keysToErase;
-        for (const auto& [jobId, ev] : _map) {
-            if (otherMap.getEntries().count(jobId)) {
-                auto& otherEv = otherMap.getEntries().at(jobId);
+        // Keep events which are not dominated by an event of the other map
+        const auto& otherEvents = otherMap._events;
+        size_t j = 0;
+        size_t numKept = 0;
+        for (size_t i = 0; i < _events.size(); i++) {
+            const auto& ev = _events[i];
+            while (j < otherEvents.size() && otherEvents[j].jobId < ev.jobId) j++;
+            if (j < otherEvents.size() && otherEvents[j].jobId == ev.jobId) {
+                const auto& otherEv = otherEvents[j];
                 if (otherEv.epoch == ev.epoch) {
                     assert(otherEv.priority == ev.priority
-                        || log_return_false(V0_CRIT, "#%i e=%i : prio %.2f != %.2f!\n", jobId, ev.epoch, ev.priority, otherEv.priority));
+                        || log_return_false(V0_CRIT, "#%i e=%i : prio %.2f != %.2f!\n", ev.jobId, ev.epoch, ev.priority, otherEv.priority));
                     assert(otherEv.demand == ev.demand
-                        || log_return_false(V0_CRIT, "#%i e=%i : demand %i != %i!\n", jobId, ev.epoch, ev.demand, otherEv.demand));
+                        || log_return_false(V0_CRIT, "#%i e=%i : demand %i != %i!\n", ev.jobId, ev.epoch, ev.demand, otherEv.demand));
                 }
                 if (otherEv.epoch >= ev.epoch) {
                     // Filtered out
-                    keysToErase.push_back(jobId);
+                    continue;
                 }
             }
+            _events[numKept++] = ev;
         }
-        for (auto key : keysToErase) _map.erase(key);
+        _events.resize(numKept);
     }
     bool updateBy(const EventMap& otherMap) {
+        // Linear merge of both maps, inserting each novel event of the other map
+        const auto& otherEvents = otherMap._events;
+        std::vector<Event> newEvents;
+        newEvents.reserve(_events.size() + otherEvents.size());
         bool change = false;
-        for (const auto& entry : otherMap.getEntries()) {
-            change |= insertIfNovel(entry.second);
+        size_t i = 0;
+        for (const auto& otherEv : otherEvents) {
+            while (i < _events.size() && _events[i].jobId < otherEv.jobId) {
+                newEvents.push_back(_events[i++]);
+            }
+            if (otherEv.epoch < 0) continue; // Old, terminated job
+            if (i < _events.size() && _events[i].jobId == otherEv.jobId) {
+                bool novel = isNovel(otherEv, _events[i]);
+                newEvents.push_back(novel ? otherEv : _events[i]);
+                change |= novel;
+                i++;
+            } else {
+                newEvents.push_back(otherEv);
+                change = true;
+            }
         }
+        newEvents.insert(newEvents.end(), _events.begin()+i, _events.end());
+        _events = std::move(newEvents);
         return change;
     }
     std::vector<int> removeOldZeros() {      
         // Remove entries for which demand and priority are set to zero
         std::vector<int> keysToErase;
-        for (const auto& [jobId, ev] : _map) {
+        size_t numKept = 0;
+        for (const auto& ev : _events) {
             if (ev.demand == 0 && ev.priority <= 0) {
                 // Filtered out
-                keysToErase.push_back(jobId);
-            }
+                keysToErase.push_back(ev.jobId);
+            } else _events[numKept++] = ev;
         }
-        for (auto key : keysToErase) _map.erase(key);
+        _events.resize(numKept);
         return keysToErase;
     }
     void remove(int key) {
-        _map.erase(key);
+        auto it = find(key);
+        if (it != _events.end() && it->jobId == key) _events.erase(it);
     }
     bool operator==(const EventMap& other) const {
         return getEntries() == other.getEntries();
@@ -175,6 +196,21 @@ public:
     bool operator!=(const EventMap& other) const {
         return !(*this == other);
     }
+
+private:
+    // First event with a job ID not smaller than the provided ID
+    std::vector<Event>::iterator find(int jobId) {
+        return std::lower_bound(_events.begin(), _events.end(), jobId, 
+            [](const Event& ev, int id) {return ev.jobId < id;});
+    }
+    std::vector<Event>::const_iterator find(int jobId) const {
+        return std::lower_bound(_events.begin(), _events.end(), jobId, 
+            [](const Event& ev, int id) {return ev.jobId < id;});
+    }
+    // Whether ev should replace the existing event of the same job
+    static bool isNovel(const Event& ev, const Event& existing) {
+        return ev.dominates(existing) && (ev.demand != existing.demand || ev.priority != existing.priority);
+    }
 };
 
 class EventDrivenBalancer : public Balancer {
@@ -191,6 +227,11 @@ public:
 
     void forget(int jobId) override;
 
+    // Computes the volume of each job in the provided (globally agreed) state
+    // for a system with numSlots job slots (#workers times active jobs per worker). Does not involve any communication.
+    static robin_hood::unordered_map<int, int> computeVolumes(const EventMap& states, int numSlots, 
+            float loadFactor, const std::string& roundingMode, int epoch, int verbosity);
+
 private:
     const int NORMAL_TREE = 1, REVERSED_TREE = 2, BOTH = 3;
     const size_t RECENT_BROADCAST_MEMORY = 3;
@@ -216,9 +257,6 @@ private:
     std::vector<int> getChildRanks(bool reversedTree);
     bool isRoot(int rank, bool reversedTree);
     bool isLeaf(int rank, bool reversedTree);
-
-    int getNewDemand(int jobId);
-    float getPriority(int jobId);
 };
 
 #endif
\ No newline at end of file
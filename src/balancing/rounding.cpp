@@ -32,4 +32,98 @@ float penalty(float utilization, float loadFactor) {
     return std::max(lowPenalty, highPenalty);
 }
 
-}
\ No newline at end of file
+void getUtilizationsPerRemainder(const robin_hood::unordered_map<int, double>& assignments,
+    SortedDoubleSequence& remainders, std::vector<int>& utilizations) {
+
+    // Collect and sort all fractional remainders
+    std::vector<double> allRemainders;
+    allRemainders.reserve(assignments.size());
+    int sumOfFloors = 0;
+    for (const auto& [jobId, assignment] : assignments) {
+        int floor = (int)assignment;
+        sumOfFloors += floor;
+        double r = assignment - floor;
+        if (r > 0) allRemainders.push_back(r);
+    }
+    std::sort(allRemainders.begin(), allRemainders.end());
+
+    // Unique remainders in (0,1)
+    std::vector<double> uniqueRemainders;
+    for (double r : allRemainders) {
+        if (r < 1 && (uniqueRemainders.empty() || r != uniqueRemainders.back())) 
+            uniqueRemainders.push_back(r);
+    }
+    remainders.setElements(std::move(uniqueRemainders));
+
+    // An assignment is rounded up iff its remainder is at least the threshold remainder:
+    // count such remainders by a single sweep from the largest remainder downwards
+    utilizations.resize(remainders.size()+1);
+    int numRoundedUp = allRemainders.end() - std::lower_bound(allRemainders.begin(), allRemainders.end(), 1.0);
+    int pos = allRemainders.size();
+    utilizations[remainders.size()] = sumOfFloors + numRoundedUp;
+    for (int idx = remainders.size()-1; idx >= 0; idx--) {
+        while (pos > 0 && allRemainders[pos-1] >= remainders[idx]) pos--;
+        utilizations[idx] = sumOfFloors + (allRemainders.size() - pos);
+    }
+}
+
+BisectionResult bisect(const SortedDoubleSequence& remainders, const std::vector<int>& utilizations, 
+    int numNodes, float loadFactor, int epoch, int verbosity) {
+
+    int lower = 0, upper = remainders.size();
+    int idx = (lower+upper)/2;
+    int iterations = 0;
+    float lastUtilization = -1;
+
+    BisectionResult best;
+    best.remainderIdx = -1;
+
+    while (true) {
+        int utilization = 0;
+        if (idx <= remainders.size()) {
+            // Utilization sum of the rounded assignments
+            utilization = utilizations[idx];
+        }
+
+        // Store result, if it is the best one so far
+        float p = penalty((float)utilization / numNodes, loadFactor);
+        if (best.remainderIdx == -1 || p < best.penalty) {
+            best.penalty = p;
+            best.remainderIdx = idx;
+            best.utilization = utilization;
+        }
+
+        // Log iteration
+        if (!remainders.isEmpty() && idx <= remainders.size()) {
+            double remainder = (idx < remainders.size() ? remainders[idx] : 1.0);
+            log(verbosity, "BLC e=%i RND it=%i [%i,%i]=>%i rmd=%.3f util=%.2f pen=%.2f\n", 
+                            epoch, iterations, lower, upper, idx,
+                            remainder, (float)utilization, p);
+        }
+
+        // Termination?
+        if (utilization == lastUtilization) { // Utilization unchanged?
+            // Finished!
+            break;
+
+        } else if (lower < upper) {
+            if (utilization < loadFactor*numNodes) {
+                // Too few resources utilized
+                upper = idx-1;
+            }
+            if (utilization > loadFactor*numNodes) {
+                // Too many resources utilized
+                lower = idx+1;
+            }
+            idx = (lower+upper)/2;
+        }
+        
+        lastUtilization = utilization;
+        iterations++;
+    }
+
+    best.iterations = iterations;
+    return best;
+}
+
+}
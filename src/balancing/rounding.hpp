@@ -7,6 +7,7 @@
 #include <set>
 #include <vector>
 #include <cstring>
+#include <algorithm>
 
 #include "data/reduceable.hpp"
 
@@ -16,11 +17,17 @@ struct SortedDoubleSequence : public Reduceable {
 SortedDoubleSequence() : data() {}
 
 void add(double x) {
-    size_t i = 0;
-    while (i < data.size() && data[i] < x) i++;
+    auto it = std::lower_bound(data.begin(), data.end(), x);
     // Only insert unique elements
-    if (i >= data.size() || x != data[i])
-        data.insert(data.begin() + i, x);
+    if (it == data.end() || x != *it)
+        data.insert(it, x);
+}
+
+// Replaces the contents with the provided (unsorted) elements in O(n log n)
+void setElements(std::vector<double>&& elements) {
+    std::sort(elements.begin(), elements.end());
+    elements.erase(std::unique(elements.begin(), elements.end()), elements.end());
+    data = std::move(elements);
 }
 
 int size() const {return data.size();}
@@ -84,6 +91,23 @@ namespace Rounding {
     robin_hood::unordered_map<int, int> getRoundedAssignments(int remainderIdx, int& sum, 
         const SortedDoubleSequence& remainders, const robin_hood::unordered_map<int, double>& assignments);
     float penalty(float utilization, float loadFactor);
+
+    // Computes the sorted unique fractional remainders of the assignments and, for each remainder 
+    // index i, the utilization (sum of rounded assignments) of getRoundedAssignments(i, ...).
+    // utilizations[remainders.size()] corresponds to rounding down each assignment. O(n log n).
+    void getUtilizationsPerRemainder(const robin_hood::unordered_map<int, double>& assignments,
+        SortedDoubleSequence& remainders, std::vector<int>& utilizations);
+
+    struct BisectionResult {
+        int remainderIdx;
+        int iterations;
+        float utilization;
+        float penalty;
+    };
+    // Bisection over the remainder indices for a rounding with a utilization close to 
+    // loadFactor*numNodes. Each iteration takes constant time.
+    BisectionResult bisect(const SortedDoubleSequence& remainders, const std::vector<int>& utilizations, 
+        int numNodes, float loadFactor, int epoch, int verbosity);
 }
 
 #endif
\ No newline at end of file
@@ -61,15 +61,27 @@ void Client::readIncomingJobs(Logger log) {
                     // Read job
                     int id = foundJob.description->getId();
                     float time = Timer::elapsedSeconds();
-                    SatReader r(foundJob.file);
                     log.log(V3_VERB, "[T] Reading job #%i (%s) ...\n", id, foundJob.file.c_str());
-                    bool success = r.read(*foundJob.description);
+                    
+                    // Look up the formula cache first
+                    uint64_t cacheKey;
+                    bool cacheable = _formula_cache.isEnabled() && _formula_cache.getKey(foundJob.file, cacheKey);
+                    bool cached = cacheable && _formula_cache.load(cacheKey, *foundJob.description);
+                    bool success = cached;
+                    if (!cached) {
+                        SatReader r(foundJob.file);
+                        success = r.read(*foundJob.description);
+                        if (success && cacheable && !_formula_cache.store(cacheKey, *foundJob.description)) {
+                            log.log(V1_WARN, "[T] [WARN] Could not write #%i to formula cache\n", id);
+                        }
+                    }
                     if (!success) {
                         log.log(V1_WARN, "[T] File %s could not be opened - skipping #%i\n", foundJob.file.c_str(), id);
                     } else {
                         time = Timer::elapsedSeconds() - time;
-                        log.log(V3_VERB, "[T] Initialized job #%i (%s) in %.3fs: %ld lits w/ separators\n", 
-                                id, foundJob.file.c_str(), time, foundJob.description->getFormulaSize());
+                        log.log(V3_VERB, "[T] Initialized job #%i (%s) in %.3fs%s: %ld lits w/ separators\n", 
+                                id, foundJob.file.c_str(), time, cached ? " from cache" : "", 
+                                foundJob.description->getFormulaSize());
                         
                         // Enqueue in ready jobs
                         auto lock = _ready_job_lock.getLock();
@@ -14,6 +14,7 @@
 #include "data/job_file_adapter.hpp"
 #include "data/job_metadata.hpp"
 #include "comm/sysstate.hpp"
+#include "util/formula_cache.hpp"
 
 #define SYSSTATE_ENTERED_JOBS 0
 #define SYSSTATE_PARSED_JOBS 1
@@ -63,12 +64,15 @@ private:
     SysState<4> _sys_state;
 
     std::thread _instance_reader_thread;
+    // Cache of parsed formulae, used by the instance reader thread.
+    FormulaCache _formula_cache;
     std::unique_ptr<JobFileAdapter> _file_adapter;
 
 public:
     Client(MPI_Comm comm, Parameters& params, std::set<int> clientRanks)
         : _comm(comm), _world_rank(MyMpi::rank(MPI_COMM_WORLD)), 
-        _params(params), _client_ranks(clientRanks), _sys_state(_comm) {}
+        _params(params), _client_ranks(clientRanks), _sys_state(_comm),
+        _formula_cache(params.getParam("fcd")) {}
     ~Client();
     void init();
     void mainProgram();
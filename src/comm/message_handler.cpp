@@ -1,9 +1,11 @@
 
-#include "message_handler.hpp" 
+#include "message_handler.hpp"
+
+#include <algorithm>
 
 const int MessageHandler::TAG_DEFAULT = -42;
 
-MessageHandler::MessageHandler() {
+MessageHandler::MessageHandler(size_t maxNumMessagesPerPoll) : _budget(std::max((size_t)1, maxNumMessagesPerPoll)) {
 
 }
 
@@ -11,13 +13,68 @@ void MessageHandler::registerCallback(int tag, const MsgCallback& cb) {
     _callbacks[tag] = cb;
 }
 
-void MessageHandler::pollMessages(float elapsedTime) {
-    // Process new messages
-    auto maybeHandle = MyMpi::poll(elapsedTime);
-    if (maybeHandle) {
-        auto& handle = *maybeHandle;
-        log(LOG_ADD_SRCRANK | V5_DEBG, "Handle Msg ID=%i tag=%i", handle.source, handle.id, handle.tag);
-        if (_callbacks.count(handle.tag)) _callbacks[handle.tag](handle);
-        else if (_callbacks.count(TAG_DEFAULT)) _callbacks[TAG_DEFAULT](handle);
+size_t MessageHandler::pollMessages(float elapsedTime) {
+
+    // Receive new messages: look ahead by up to the budget itself
+    // so that messages of different tags can compete for the budget
+    if (_received.size() < 2*_budget) {
+        MyMpi::poll(_received, elapsedTime, 2*_budget - _received.size());
+    }
+    if (_received.empty()) return 0;
+
+    if (_received.size() <= _budget) {
+        // Process all messages in order of reception
+        std::vector<MessageHandlePtr> handles = std::move(_received);
+        _received.clear();
+        for (auto& handle : handles) process(*handle);
+        return handles.size();
+    }
+
+    // Too many messages: Select messages in rounds, allowing each source
+    // one more message in each round, until the budget is exhausted.
+    // The messages selected from a source are always the oldest ones
+    // from this source, so messages from one source are never reordered.
+    _num_selected_per_source.clear();
+    _selected.assign(_received.size(), false);
+    size_t numSelected = 0;
+    for (size_t round = 1; numSelected < _budget; round++) {
+        size_t numSelectedBefore = numSelected;
+        for (size_t i = 0; i < _received.size() && numSelected < _budget; i++) {
+            if (_selected[i]) continue;
+            auto& numOfSource = _num_selected_per_source[_received[i]->source];
+            if (numOfSource >= round) continue;
+            numOfSource++;
+            _selected[i] = true;
+            numSelected++;
+        }
+        if (numSelected == numSelectedBefore) break;
+    }
+
+    // Separate selected messages from the remaining ones, keeping their order
+    std::vector<MessageHandlePtr> handles;
+    handles.reserve(numSelected);
+    size_t offset = 0;
+    for (size_t i = 0; i < _received.size(); i++) {
+        if (_selected[i]) {
+            handles.push_back(std::move(_received[i]));
+            offset++;
+        } else if (offset > 0) {
+            _received[i-offset] = std::move(_received[i]);
+        }
     }
-}
\ No newline at end of file
+    _received.resize(_received.size()-offset);
+
+    log(V5_DEBG, "Process %lu msgs, defer %lu msgs\n", handles.size(), _received.size());
+    for (auto& handle : handles) process(*handle);
+    return handles.size();
+}
+
+bool MessageHandler::hasUnprocessedMessages() const {
+    return !_received.empty();
+}
+
+void MessageHandler::process(MessageHandle& handle) {
+    log(LOG_ADD_SRCRANK | V5_DEBG, "Handle Msg ID=%i tag=%i", handle.source, handle.id, handle.tag);
+    if (_callbacks.count(handle.tag)) _callbacks[handle.tag](handle);
+    else if (_callbacks.count(TAG_DEFAULT)) _callbacks[TAG_DEFAULT](handle);
+}
@@ -1,4 +1,3 @@
-
 #ifndef DOMPASCH_MALLOB_MESSAGE_HANDLER
 #define DOMPASCH_MALLOB_MESSAGE_HANDLER
 
@@ -17,11 +16,29 @@ public:
 private:
     robin_hood::unordered_map<int, MsgCallback> _callbacks;
 
+    // Max. number of messages to process per call to pollMessages
+    size_t _budget;
+    // Received messages which have not been processed yet, in order of reception
+    std::vector<MessageHandlePtr> _received;
+    robin_hood::unordered_map<int, size_t> _num_selected_per_source;
+    std::vector<bool> _selected;
+
 public:
-    MessageHandler();
+    MessageHandler(size_t maxNumMessagesPerPoll = 1);
     void registerCallback(int tag, const MsgCallback& cb);
-    void pollMessages(float elapsedTime);
 
+    /*
+    Receives pending messages (up to twice the budget) and processes up to the budget of them.
+    If there are more messages than that, each source rank gets an equal share of the budget
+    such that a burst of messages from one rank cannot delay all other messages.
+    Messages from the same rank are processed in order of reception.
+    Returns the number of processed messages.
+    */
+    size_t pollMessages(float elapsedTime);
+    bool hasUnprocessedMessages() const;
+
+private:
+    void process(MessageHandle& handle);
 };
 
-#endif
\ No newline at end of file
+#endif
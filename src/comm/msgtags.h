@@ -157,6 +157,7 @@ const int MSG_NOTIFY_RESULT_OBSOLETE = 31;
 
 /*
 Pseudo-tag representing all tags that can be received at any time.
+Such messages are probed first and then received into a buffer of exact size.
 NOT a tag to be used outside of MyMpi.*.
 */
 const int MSG_ANYTIME = 1337;
@@ -11,10 +11,13 @@
 #include "util/logger.hpp"
 #include "comm/mpi_monitor.hpp"
 
+// Max. size in bytes of a control message received into a preallocated buffer
+#define SMALL_MSG_SIZE 128
+
 #define MPICALL(cmd, str) {if (!MyMpi::_monitor_off) {initcall((str).c_str());} \
 int err = cmd; if (!MyMpi::_monitor_off) endcall(); chkerr(err);}
 
-int MyMpi::_max_msg_length;
+int MyMpi::_max_small_msg_length;
 std::vector<MessageHandlePtr> MyMpi::_handles;
 std::vector<MessageHandlePtr> MyMpi::_sent_handles;
 robin_hood::unordered_map<int, MsgTag> MyMpi::_tags;
@@ -50,6 +53,19 @@ bool MessageHandle::testReceived() {
         // Self message / fabricated message is invariantly ready to be processed
         finished = true;
     } else {
+        if (probing) {
+            // Probe for a matching message, then receive it with a buffer of exact size
+            int flag = 0;
+            MPI_Message message;
+            MPI_Status probeStatus;
+            MPICALL(MPI_Improbe(source, tag, probeComm, &flag, &message, &probeStatus), "improbe" + std::to_string(id))
+            if (!flag) return false;
+            int count = 0;
+            MPICALL(MPI_Get_count(&probeStatus, MPI_BYTE, &count), "getcount" + std::to_string(id))
+            recvData.resize(count);
+            MPICALL(MPI_Imrecv(recvData.data(), count, MPI_BYTE, &message, &request), "imrecv" + std::to_string(id))
+            probing = false;
+        }
         // MPI_Test message
         int flag = -1;
         MPICALL(MPI_Test(&request, &flag, &status), "testrecvd" + std::to_string(id))
@@ -66,7 +82,9 @@ bool MessageHandle::testReceived() {
         if (!selfMessage) {
             int count = 0;
             MPICALL(MPI_Get_count(&status, MPI_BYTE, &count), "getcount" + std::to_string(id))
-            if (count > 0 && count != MPI_UNDEFINED && count < (int)recvData.size()) {
+            if (recvTarget) {
+                if (count != MPI_UNDEFINED) recvTargetSize = count;
+            } else if (count > 0 && count != MPI_UNDEFINED && count < (int)recvData.size()) {
                 recvData.resize(count);
             }
         }
@@ -87,6 +105,8 @@ bool MessageHandle::shouldCancel(float elapsedTime) {
 }
 
 void MessageHandle::cancel() {
+    // Nothing to cancel if no receive has been posted yet
+    if (probing) return;
     MPICALL(MPI_Cancel(&request), "cancel" + std::to_string(id))
 }
 
@@ -108,41 +128,47 @@ void MyMpi::init(int argc, char *argv[]) {
     handleId = 1;
 
     std::vector<MsgTag> tagList;
-    /*                   Tag name                           anytime  */
-    tagList.emplace_back(MSG_NOTIFY_JOB_ABORTING,           true); 
-    tagList.emplace_back(MSG_ACCEPT_ADOPTION_OFFER,         true); 
-    tagList.emplace_back(MSG_CONFIRM_JOB_REVISION_DETAILS,  true);
-    tagList.emplace_back(MSG_REDUCE_DATA,                   true);
-    tagList.emplace_back(MSG_BROADCAST_DATA,                true);
-    tagList.emplace_back(MSG_COLLECTIVE_OPERATION,          false);
-    tagList.emplace_back(MSG_CONFIRM_ADOPTION,              true);
-    tagList.emplace_back(MSG_DO_EXIT,                       true);   
-    tagList.emplace_back(MSG_REQUEST_NODE,                  true);
-    tagList.emplace_back(MSG_REQUEST_NODE_ONESHOT,          true);
-    tagList.emplace_back(MSG_SEND_CLIENT_RANK,              true);
-    tagList.emplace_back(MSG_INCREMENTAL_JOB_FINISHED,      true);
-    tagList.emplace_back(MSG_INTERRUPT,                     true); 
-    tagList.emplace_back(MSG_SEND_APPLICATION_MESSAGE,      true); 
-    tagList.emplace_back(MSG_NOTIFY_JOB_DONE,               true);
-    tagList.emplace_back(MSG_NOTIFY_JOB_REVISION,           true); 
-    tagList.emplace_back(MSG_OFFER_ADOPTION,                true); 
-    tagList.emplace_back(MSG_REJECT_ONESHOT,                true); 
-    tagList.emplace_back(MSG_QUERY_JOB_RESULT,              true); 
-    tagList.emplace_back(MSG_QUERY_JOB_REVISION_DETAILS,    true); 
-    tagList.emplace_back(MSG_QUERY_VOLUME,                  true); 
-    tagList.emplace_back(MSG_REJECT_ADOPTION_OFFER,         true); 
-    tagList.emplace_back(MSG_NOTIFY_RESULT_OBSOLETE,        true);
-    tagList.emplace_back(MSG_SEND_JOB_DESCRIPTION,          false); 
-    tagList.emplace_back(MSG_SEND_JOB_RESULT,               false); 
-    tagList.emplace_back(MSG_SEND_JOB_REVISION_DATA,        false);
-    tagList.emplace_back(MSG_SEND_JOB_REVISION_DETAILS,     true); 
-    tagList.emplace_back(MSG_NOTIFY_JOB_TERMINATING,        true); 
-    tagList.emplace_back(MSG_NOTIFY_VOLUME_UPDATE,          true); 
-    tagList.emplace_back(MSG_WARMUP,                        true); 
-    tagList.emplace_back(MSG_NOTIFY_RESULT_FOUND,           true);
-    tagList.emplace_back(MSG_NOTIFY_NODE_LEAVING_JOB,       true); 
+    /*                   Tag name                           anytime max. size */
+    tagList.emplace_back(MSG_NOTIFY_JOB_ABORTING,           true,   SMALL_MSG_SIZE); 
+    tagList.emplace_back(MSG_ACCEPT_ADOPTION_OFFER,         true,   SMALL_MSG_SIZE); 
+    tagList.emplace_back(MSG_CONFIRM_JOB_REVISION_DETAILS,  true,   SMALL_MSG_SIZE);
+    tagList.emplace_back(MSG_REDUCE_DATA,                   true,   0);
+    tagList.emplace_back(MSG_BROADCAST_DATA,                true,   0);
+    tagList.emplace_back(MSG_COLLECTIVE_OPERATION,          false,  0);
+    tagList.emplace_back(MSG_CONFIRM_ADOPTION,              true,   SMALL_MSG_SIZE);
+    tagList.emplace_back(MSG_DO_EXIT,                       true,   SMALL_MSG_SIZE);   
+    tagList.emplace_back(MSG_REQUEST_NODE,                  true,   SMALL_MSG_SIZE);
+    tagList.emplace_back(MSG_REQUEST_NODE_ONESHOT,          true,   SMALL_MSG_SIZE);
+    tagList.emplace_back(MSG_SEND_CLIENT_RANK,              true,   SMALL_MSG_SIZE);
+    tagList.emplace_back(MSG_INCREMENTAL_JOB_FINISHED,      true,   SMALL_MSG_SIZE);
+    tagList.emplace_back(MSG_INTERRUPT,                     true,   SMALL_MSG_SIZE); 
+    tagList.emplace_back(MSG_SEND_APPLICATION_MESSAGE,      true,   0); 
+    tagList.emplace_back(MSG_NOTIFY_JOB_DONE,               true,   SMALL_MSG_SIZE);
+    tagList.emplace_back(MSG_NOTIFY_JOB_REVISION,           true,   SMALL_MSG_SIZE); 
+    tagList.emplace_back(MSG_OFFER_ADOPTION,                true,   SMALL_MSG_SIZE); 
+    tagList.emplace_back(MSG_REJECT_ONESHOT,                true,   SMALL_MSG_SIZE); 
+    tagList.emplace_back(MSG_QUERY_JOB_RESULT,              true,   SMALL_MSG_SIZE); 
+    tagList.emplace_back(MSG_QUERY_JOB_REVISION_DETAILS,    true,   SMALL_MSG_SIZE); 
+    tagList.emplace_back(MSG_QUERY_VOLUME,                  true,   SMALL_MSG_SIZE); 
+    tagList.emplace_back(MSG_REJECT_ADOPTION_OFFER,         true,   SMALL_MSG_SIZE); 
+    tagList.emplace_back(MSG_NOTIFY_RESULT_OBSOLETE,        true,   SMALL_MSG_SIZE);
+    tagList.emplace_back(MSG_SEND_JOB_DESCRIPTION,          false,  0); 
+    tagList.emplace_back(MSG_SEND_JOB_RESULT,               false,  0); 
+    tagList.emplace_back(MSG_SEND_JOB_REVISION_DATA,        false,  0);
+    tagList.emplace_back(MSG_SEND_JOB_REVISION_DETAILS,     true,   SMALL_MSG_SIZE); 
+    tagList.emplace_back(MSG_NOTIFY_JOB_TERMINATING,        true,   SMALL_MSG_SIZE); 
+    tagList.emplace_back(MSG_NOTIFY_VOLUME_UPDATE,          true,   SMALL_MSG_SIZE); 
+    tagList.emplace_back(MSG_WARMUP,                        true,   SMALL_MSG_SIZE); 
+    tagList.emplace_back(MSG_NOTIFY_RESULT_FOUND,           true,   SMALL_MSG_SIZE);
+    tagList.emplace_back(MSG_NOTIFY_NODE_LEAVING_JOB,       true,   SMALL_MSG_SIZE); 
     
-    for (const auto& tag : tagList) _tags[tag.id] = tag;
+    _max_small_msg_length = 0;
+    for (const auto& tag : tagList) {
+        _tags[tag.id] = tag;
+        if (tag.anytime) _max_small_msg_length = std::max(_max_small_msg_length, tag.maxSize);
+    }
+    // Room for the application tag appended to each anytime message
+    _max_small_msg_length += sizeof(int);
 }
 
 void MyMpi::setOptions(const Parameters& params) {
@@ -156,7 +182,6 @@ void MyMpi::setOptions(const Parameters& params) {
         log(verb, "Enabling latency monkey\n");
         _monkey_flags |= MONKEY_LATENCY;
     }
-    _max_msg_length = sizeof(int) * MyMpi::size(MPI_COMM_WORLD) * params.getIntParam("cbbs") + 1024;
 }
 
 void MyMpi::beginListening() {
@@ -187,6 +212,18 @@ void MyMpi::isend(MPI_Comm communicator, int recvRank, int tag, const std::vecto
     doIsend(communicator, recvRank, tag);
 }
 
+void MyMpi::isend(MPI_Comm communicator, int recvRank, int tag, std::vector<uint8_t>&& object) {
+
+    bool selfMessage = rank(communicator) == recvRank;
+    auto& handles = (selfMessage ? _handles : _sent_handles);
+
+    // Append a single zero to an otherwise empty message
+    if (object.empty()) object.push_back(0);
+    handles.emplace_back(new MessageHandle(nextHandleId(), std::move(object)));
+
+    doIsend(communicator, recvRank, tag);
+}
+
 void MyMpi::isend(MPI_Comm communicator, int recvRank, int tag, const std::shared_ptr<std::vector<uint8_t>>& object) {
 
     bool selfMessage = rank(communicator) == recvRank;
@@ -202,6 +239,18 @@ void MyMpi::isend(MPI_Comm communicator, int recvRank, int tag, const std::share
     doIsend(communicator, recvRank, tag);
 }
 
+void MyMpi::isend(MPI_Comm communicator, int recvRank, int tag, const std::shared_ptr<std::vector<uint8_t>>& object, 
+        size_t offset, size_t size) {
+
+    assert(!isAnytimeTag(tag));
+    assert(size > 0 && offset+size <= object->size());
+    bool selfMessage = rank(communicator) == recvRank;
+    auto& handles = (selfMessage ? _handles : _sent_handles);
+    handles.emplace_back(new MessageHandle(nextHandleId(), object, offset, size));
+
+    doIsend(communicator, recvRank, tag);
+}
+
 void MyMpi::doIsend(MPI_Comm communicator, int recvRank, int tag) {
 
     latencyMonkey();
@@ -214,21 +263,27 @@ void MyMpi::doIsend(MPI_Comm communicator, int recvRank, int tag) {
     int appTag = tag;
 
     // Overwrite tag as MSG_ANYTIME, append application tag to message
+    // (large payloads are not copied for this purpose)
     if (isAnytimeTag(tag)) {
-        handle.appendTagToSendData(tag);
+        handle.appendTagToSendData(tag, /*maxCopySize=*/_max_small_msg_length);
         tag = MSG_ANYTIME;
-        assert(handle.getSendData().size() <= _max_msg_length 
-            || log_return_false("Too long message of size %i\n", _max_msg_length));
     }
     handle.tag = tag;
 
     log(V5_DEBG, "Msg ID=%i dest=%i tag=%i size=%i\n", handle.id, 
-                recvRank, appTag, handle.getSendData().size());
+                recvRank, appTag, handle.getSendSize());
     
     if (selfMessage) {
-        handle.receiveSelfMessage(handle.getSendData(), recvRank);
+        handle.receiveOwnSendData(recvRank);
+    } else if (handle.usesSendTail()) {
+        // Send payload and tail slot without copying them into a single buffer;
+        // the datatype is only deallocated after the send completed
+        MPI_Datatype type = handle.createSendType();
+        MPICALL(MPI_Isend(MPI_BOTTOM, 1, type, recvRank, 
+                tag, communicator, &handle.request), "isend"+std::to_string(handle.id))
+        MPI_Type_free(&type);
     } else {
-        MPICALL(MPI_Isend(handle.getSendData().data(), handle.getSendData().size(), MPI_BYTE, recvRank, 
+        MPICALL(MPI_Isend(handle.getSendBuffer(), handle.getSendSize(), MPI_BYTE, recvRank, 
                 tag, communicator, &handle.request), "isend"+std::to_string(handle.id))
     }
 }
@@ -263,16 +318,39 @@ void MyMpi::irecv(MPI_Comm communicator, int tag) {
 }
 
 void MyMpi::irecv(MPI_Comm communicator, int source, int tag) {
+    // Message of unknown size
+    irecvProbed(communicator, source, tag);
+}
+
+void MyMpi::irecv(MPI_Comm communicator, int source, int tag, 
+        const std::shared_ptr<std::vector<uint8_t>>& target, size_t offset, int size) {
 
-    int msgSize = _max_msg_length;
-    _handles.emplace_back(new MessageHandle(nextHandleId(), msgSize));
+    assert(source >= 0);
+    assert(!isAnytimeTag(tag));
+    assert(offset+size <= target->size());
+    _handles.emplace_back(new MessageHandle(nextHandleId()));
     auto& handle = *_handles.back();
-    handle.tag = tag;
 
-    MPICALL(MPI_Irecv(handle.recvData.data(), msgSize, MPI_BYTE, source, isAnytimeTag(tag) ? MSG_ANYTIME : tag, 
+    handle.source = source;
+    handle.tag = tag;
+    handle.recvTarget = target;
+    handle.recvTargetOffset = offset;
+    handle.recvTargetSize = size;
+    MPICALL(MPI_Irecv(target->data()+offset, size, MPI_BYTE, source, tag, 
                 communicator, &handle.request), "irecv"+std::to_string(handle.id))
 }
 
+void MyMpi::irecvProbed(MPI_Comm communicator, int source, int tag) {
+
+    // The actual receive is posted as soon as a matching message is probed
+    _handles.emplace_back(new MessageHandle(nextHandleId()));
+    auto& handle = *_handles.back();
+    handle.tag = isAnytimeTag(tag) ? MSG_ANYTIME : tag;
+    handle.source = source;
+    handle.probing = true;
+    handle.probeComm = communicator;
+}
+
 void MyMpi::irecv(MPI_Comm communicator, int source, int tag, int size) {
 
     assert(source >= 0);
@@ -310,44 +388,61 @@ bool MyMpi::test(MPI_Request& request, MPI_Status& status) {
 }
 
 MessageHandlePtr MyMpi::poll(float elapsedTime) {
+    std::vector<MessageHandlePtr> found;
+    poll(found, elapsedTime, 1);
+    if (found.empty()) return MessageHandlePtr();
+    return std::move(found.front());
+}
 
-    MessageHandlePtr foundHandle;
+size_t MyMpi::poll(std::vector<MessageHandlePtr>& found, float elapsedTime, size_t maxNumHandles) {
 
-    // Find some ready handle
+    size_t numFound = 0;
+
+    // Find all ready handles (up to the provided maximum)
     size_t offset = 0;
     size_t size = _handles.size();
     for (size_t i = 0; i < size; i++) {
-        auto& h = _handles[i];
-        if (!foundHandle && h->testReceived()) {
+
+        bool remove = false;
+        while (numFound < maxNumHandles && _handles[i]->testReceived()) {
             
             // Handle found!
-            foundHandle = std::move(h);
+            found.push_back(std::move(_handles[i]));
+            numFound++;
+            auto& foundHandle = found.back();
 
             // Any listener to reset?
             if (!foundHandle->selfMessage && isAnytimeTag(foundHandle->tag)) {
                 // Reset listener, appending a new handle to _handles
-                MyMpi::irecv(MPI_COMM_WORLD, MSG_ANYTIME);
+                int listenerTag = MSG_ANYTIME;
+                MyMpi::irecv(MPI_COMM_WORLD, listenerTag);
                 // Move new handle from the back to the current position
+                // and test it right away to drain a burst of messages
                 _handles[i] = std::move(_handles.back());
                 _handles.resize(_handles.size()-1);
-                log(V5_DEBG, "Msg ID=%i : listening to tag %i\n", _handles[i]->id, MSG_ANYTIME);
+                log(V5_DEBG, "Msg ID=%i : listening to tag %i\n", _handles[i]->id, listenerTag);
             } else {
                 // Overwrite this position
-                offset++;
+                remove = true;
+                break;
             }
+        }
 
-        } else if (h->shouldCancel(elapsedTime)) {
+        if (!remove && _handles[i]->shouldCancel(elapsedTime)) {
             // Cancel handle, mark this position to be overwritten
-            h->cancel();
-            offset++;
+            _handles[i]->cancel();
+            remove = true;
+        }
 
+        if (remove) {
+            offset++;
         } else if (offset > 0) {
             // Handle is not finished yet: Overwrite old handle
             _handles[i-offset] = std::move(_handles[i]);
         }
     }
     if (offset > 0) _handles.resize(size-offset);
-    return foundHandle;
+    return numFound;
 }
 
 bool MyMpi::hasOpenSentHandles() {
@@ -23,14 +23,18 @@
 
 /*
 Struct representing one of the tags defined in msgtags.h.
-Future versions may extend this struct with additional meta information
-(e.g. maximum message size) per tag.
+maxSize is the number of bytes a message of this tag usually does not exceed
+(0: no bound). All anytime messages share a single MPI tag, which preserves
+MPI's order among messages from the same source; each message is probed and
+then received into a buffer of exact size. Within maxSize, the application tag
+is appended to a copy of the message instead of being sent as a separate part.
 */
 struct MsgTag {
     int id;
     bool anytime;
+    int maxSize;
     MsgTag() {}
-    MsgTag(int id, bool anytime) : id(id), anytime(anytime) {}
+    MsgTag(int id, bool anytime, int maxSize) : id(id), anytime(anytime), maxSize(maxSize) {}
 };
 
 struct MessageHandle;
@@ -42,7 +46,7 @@ public:
     static const int MONKEY_LATENCY = 1;
     static const int MONKEY_DELAY = 2;
 
-    static int _max_msg_length;
+    static int _max_small_msg_length;
     static bool _monitor_off;
     static int _monkey_flags;
 
@@ -52,11 +56,20 @@ public:
 
     static void isend(MPI_Comm communicator, int recvRank, int tag, const Serializable& object);
     static void isend(MPI_Comm communicator, int recvRank, int tag, const std::vector<uint8_t>& object);
+    // Takes ownership of the object and sends it without copying it.
+    static void isend(MPI_Comm communicator, int recvRank, int tag, std::vector<uint8_t>&& object);
+    // Sends the object without copying or modifying it.
     static void isend(MPI_Comm communicator, int recvRank, int tag, const std::shared_ptr<std::vector<uint8_t>>& object);
+    // Sends the slice [offset, offset+size) of the object without copying it (non-anytime tags only).
+    static void isend(MPI_Comm communicator, int recvRank, int tag, const std::shared_ptr<std::vector<uint8_t>>& object, 
+            size_t offset, size_t size);
     static void irecv(MPI_Comm communicator);
     static void irecv(MPI_Comm communicator, int tag);
     static void irecv(MPI_Comm communicator, int source, int tag);
     static void irecv(MPI_Comm communicator, int source, int tag, int size);
+    // Receives a message of at most <size> bytes directly into target, beginning at the given offset.
+    static void irecv(MPI_Comm communicator, int source, int tag, 
+            const std::shared_ptr<std::vector<uint8_t>>& target, size_t offset, int size);
     /*
     static MessageHandlePtr  send(MPI_Comm communicator, int recvRank, int tag, const Serializable& object);
     static MessageHandlePtr  send(MPI_Comm communicator, int recvRank, int tag, const std::shared_ptr<std::vector<uint8_t>>& object);
@@ -70,6 +83,9 @@ public:
     static bool test(MPI_Request& request, MPI_Status& status);
 
     static MessageHandlePtr poll(float elapsedTime = Timer::elapsedSeconds());
+    // Moves up to maxNumHandles received handles to the back of "found".
+    // Returns the number of handles found.
+    static size_t poll(std::vector<MessageHandlePtr>& found, float elapsedTime, size_t maxNumHandles);
     static int getNumActiveHandles() {
         return _handles.size();
     }
@@ -93,6 +109,7 @@ private:
     static robin_hood::unordered_map<int, MsgTag> _tags;
 
     static void doIsend(MPI_Comm communicator, int recvRank, int tag);
+    static void irecvProbed(MPI_Comm communicator, int source, int tag);
     static void resetListenerIfNecessary(int tag);
 };
 
@@ -104,7 +121,17 @@ struct MessageHandle {
 
 private:
     std::shared_ptr<std::vector<uint8_t>> sendData;
+    // If set, sendData belongs to this handle alone and may be modified
+    bool sendDataOwned = false;
+    // Tail slot for the application tag of an anytime message whose payload cannot
+    // be extended without a copy; the payload and the tail are sent as one message
+    int sendTail = 0;
+    bool hasSendTail = false;
     std::vector<uint8_t> recvData;
+    // If sendSlice is set, only sendData[sendOffset, sendOffset+sendLength) is sent
+    bool sendSlice = false;
+    size_t sendOffset = 0;
+    size_t sendLength = 0;
 
 public:
     int id;
@@ -112,6 +139,14 @@ public:
     int source;
     bool selfMessage = false;
     bool finished = false;
+    // If set, the message still needs to be probed and received via "probeComm"
+    bool probing = false;
+    MPI_Comm probeComm;
+    // If set, the message is received into this external buffer (beginning at recvTargetOffset)
+    // instead of into recvData. recvTargetSize is the posted size and, when finished, the received size.
+    std::shared_ptr<std::vector<uint8_t>> recvTarget;
+    size_t recvTargetOffset = 0;
+    int recvTargetSize = 0;
     float creationTime = 0;
     MPI_Request request;
     MPI_Status status;
@@ -129,18 +164,31 @@ public:
         //log(V5_DEBG, "Msg ID=%i created\n", id);
     }
     MessageHandle(int id, const std::vector<uint8_t>& data, float time = Timer::elapsedSeconds()) : 
-            id(id), sendData(new std::vector<uint8_t>(data)), creationTime(time) {
+            sendData(new std::vector<uint8_t>(data)), sendDataOwned(true), id(id), creationTime(time) {
+        status.MPI_SOURCE = -1; 
+        status.MPI_TAG = -1;
+        //log(V5_DEBG, "Msg ID=%i created\n", id);
+    }
+    MessageHandle(int id, std::vector<uint8_t>&& data, float time = Timer::elapsedSeconds()) : 
+            sendData(new std::vector<uint8_t>(std::move(data))), sendDataOwned(true), id(id), creationTime(time) {
         status.MPI_SOURCE = -1; 
         status.MPI_TAG = -1;
         //log(V5_DEBG, "Msg ID=%i created\n", id);
     }
     MessageHandle(int id, const std::shared_ptr<std::vector<uint8_t>>& data, float time = Timer::elapsedSeconds()) : 
-            id(id), sendData(data), creationTime(time) {
+            sendData(data), id(id), creationTime(time) {
         status.MPI_SOURCE = -1; 
         status.MPI_TAG = -1;
         //log(V5_DEBG, "Msg ID=%i created\n", id);
     }
 
+    MessageHandle(int id, const std::shared_ptr<std::vector<uint8_t>>& data, size_t offset, size_t size, 
+            float time = Timer::elapsedSeconds()) : 
+            sendData(data), sendSlice(true), sendOffset(offset), sendLength(size), id(id), creationTime(time) {
+        status.MPI_SOURCE = -1; 
+        status.MPI_TAG = -1;
+    }
+
     MessageHandle(MessageHandle& other) = delete;
     MessageHandle(MessageHandle&& other) = delete;
     /*
@@ -172,16 +220,61 @@ public:
     }*/
 
     const std::vector<uint8_t>& getSendData() const { return *sendData;}
+    const uint8_t* getSendBuffer() const { return sendData->data() + (sendSlice ? sendOffset : 0);}
+    // Size of the sent message, including the tail slot (if used)
+    size_t getSendSize() const { return (sendSlice ? sendLength : sendData->size()) + (hasSendTail ? sizeof(int) : 0);}
+    bool usesSendTail() const { return hasSendTail;}
     const std::vector<uint8_t>& getRecvData() const { return recvData;}
     std::vector<uint8_t>&& moveRecvData() { return std::move(recvData);}
 
-    void appendTagToSendData(int tag) {
-        int prevSize = sendData->size();
+    // Appends the tag to the payload if this requires no reallocation or if the payload
+    // is small (at most maxCopySize bytes). A shared payload is never modified but copied.
+    // Otherwise, the tag is put into the tail slot.
+    void appendTagToSendData(int tag, size_t maxCopySize) {
+        assert(!sendSlice);
+        size_t prevSize = sendData->size();
+        bool inPlace = sendDataOwned && sendData->capacity() >= prevSize+sizeof(int);
+        if (!inPlace && prevSize > maxCopySize) {
+            sendTail = tag;
+            hasSendTail = true;
+            return;
+        }
+        if (!sendDataOwned) {
+            auto copy = std::make_shared<std::vector<uint8_t>>();
+            copy->reserve(prevSize+sizeof(int));
+            copy->insert(copy->end(), sendData->begin(), sendData->end());
+            sendData = std::move(copy);
+            sendDataOwned = true;
+        }
         sendData->resize(prevSize+sizeof(int));
         memcpy(sendData->data()+prevSize, &tag, sizeof(int));
     }
-    void receiveSelfMessage(const std::vector<uint8_t>& recvData, int rank) {
-        this->recvData = recvData;
+    // Datatype describing the payload followed by the tail slot
+    // (only valid as long as this handle exists)
+    MPI_Datatype createSendType() {
+        int lengths[2] = {(int) sendData->size(), (int) sizeof(int)};
+        MPI_Aint displacements[2];
+        MPI_Get_address(sendData->data(), &displacements[0]);
+        MPI_Get_address(&sendTail, &displacements[1]);
+        MPI_Datatype type;
+        MPI_Type_create_hindexed(2, lengths, displacements, MPI_BYTE, &type);
+        MPI_Type_commit(&type);
+        return type;
+    }
+    void receiveSelfMessage(std::vector<uint8_t>&& recvData, int rank) {
+        this->recvData = std::move(recvData);
+        source = rank;
+        selfMessage = true;
+    }
+    // Receives the own send data as a self message, moving it if possible
+    void receiveOwnSendData(int rank) {
+        if (sendDataOwned && !sendSlice) recvData = std::move(*sendData);
+        else recvData.assign(getSendBuffer(), getSendBuffer()+(sendSlice ? sendLength : sendData->size()));
+        if (hasSendTail) {
+            size_t prevSize = recvData.size();
+            recvData.resize(prevSize+sizeof(int));
+            memcpy(recvData.data()+prevSize, &sendTail, sizeof(int));
+        }
         source = rank;
         selfMessage = true;
     }
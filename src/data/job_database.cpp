@@ -17,9 +17,8 @@ JobDatabase::JobDatabase(Parameters& params, MPI_Comm& comm):
         _params(params), _comm(comm) {
     _wcsecs_per_instance = params.getFloatParam("job-wallclock-limit");
     _cpusecs_per_instance = params.getFloatParam("job-cpu-limit");
-    _load = 0;
+    _num_slots = std::max(1, params.getIntParam("ajpw"));
     _last_balancing_initiation = 0;
-    _current_job = NULL;
     _load_factor = params.getFloatParam("l");
     assert(0 < _load_factor && _load_factor <= 1.0);
     _balance_period = params.getFloatParam("p");       
@@ -102,80 +101,28 @@ void JobDatabase::free(int jobId) {
 }
 
 bool JobDatabase::isRequestObsolete(const JobRequest& req) {
-
-    // Requests for a job root never become obsolete
-    if (req.requestedNodeIndex == 0) return false;
-
-    if (has(req.jobId)) {
-        Job& job = get(req.jobId);
-        if (job.getState() == PAST) {
-            // Job has already terminated!
-            log(V4_VVER, "%s : past job\n", req.toStr().c_str());
-            return true;
-        }
-        if (job.getState() == ACTIVE) {
-            // Does this node KNOW that the request is already completed?
-            if (req.requestedNodeIndex == job.getIndex()
-            || (job.getJobTree().hasLeftChild() && req.requestedNodeIndex == job.getJobTree().getLeftChildIndex())
-            || (job.getJobTree().hasRightChild() && req.requestedNodeIndex == job.getJobTree().getRightChildIndex())) {
-                // Request already completed!
-                log(V4_VVER, "%s : already completed\n", req.toStr().c_str());
-                return true;
-            }
-            // Am I the transitive parent of the request and do I know
-            // that the job's volume does not allow for this node any more? 
-            if (job.getVolume() > 0 && job.getVolume() <= req.requestedNodeIndex 
-                    && job.getJobTree().isTransitiveParentOf(req.requestedNodeIndex)) {
-                log(V4_VVER, "%s : new volume too small\n", req.toStr().c_str());
-                return true;
-            }
-        }
-    }
-    
     float maxAge = _params.getFloatParam("rto"); // request time out
-    if (maxAge > 0) {
-        //float timelim = 0.25 + 2 * params.getFloatParam("p");
-        return Timer::elapsedSeconds() - req.timeOfBirth >= maxAge; 
-    } else {
-        return false; // not obsolete
-    }
+    return JobPlacement::isRequestObsolete(req, getJobView(req.jobId), Timer::elapsedSeconds(), maxAge);
 }
 
 bool JobDatabase::isAdoptionOfferObsolete(const JobRequest& req, bool alreadyAccepted) {
+    return JobPlacement::isAdoptionOfferObsolete(req, getJobView(req.jobId), alreadyAccepted);
+}
 
-    // Requests for a job root never become obsolete
-    if (req.requestedNodeIndex == 0) return false;
-
-    // Job not known anymore: obsolete
-    if (!has(req.jobId)) return true;
-
-    Job& job = get(req.jobId);
-    if (job.getState() != ACTIVE) {
-        // Job is not active
-        log(V4_VVER, "Req. %s : job inactive (%s)\n", job.toStr(), job.jobStateToStr());
-        return true;
-    
-    } else if (req.requestedNodeIndex != job.getJobTree().getLeftChildIndex() 
-            && req.requestedNodeIndex != job.getJobTree().getRightChildIndex()) {
-        // Requested node index is not a valid child index for this job
-        log(V4_VVER, "Req. %s : not a valid child index (any more)\n", job.toStr());
-        return true;
-
-    } else if (alreadyAccepted) {
-        return false;
-
-    } else if (req.requestedNodeIndex == job.getJobTree().getLeftChildIndex() && job.getJobTree().hasLeftChild()) {
-        // Job already has a left child
-        log(V4_VVER, "Req. %s : already has left child\n", job.toStr());
-        return true;
-
-    } else if (req.requestedNodeIndex == job.getJobTree().getRightChildIndex() && job.getJobTree().hasRightChild()) {
-        // Job already has a right child
-        log(V4_VVER, "Req. %s : already has right child\n", job.toStr());
-        return true;
-    }
-
-    return false;
+JobPlacement::JobView JobDatabase::getJobView(int jobId) const {
+    JobPlacement::JobView view;
+    view.commSize = MyMpi::size(_comm);
+    if (!has(jobId)) return view;
+    const Job& job = get(jobId);
+    view.known = true;
+    view.past = job.getState() == PAST;
+    view.active = job.getState() == ACTIVE;
+    view.suspended = job.getState() == SUSPENDED;
+    view.index = job.getIndex();
+    view.volume = job.getVolume();
+    view.hasLeftChild = job.getJobTree().hasLeftChild();
+    view.hasRightChild = job.getJobTree().hasRightChild();
+    return view;
 }
 
 void JobDatabase::commit(JobRequest& req) {
@@ -204,58 +151,37 @@ JobDatabase::AdoptionResult JobDatabase::tryAdopt(const JobRequest& req, bool on
 
     // Decide whether job should be adopted or bounced to another node
     removedJob = -1;
-    
-    // Already have another commitment?
-    if (_has_commitment) return REJECT;
 
-    if (has(req.jobId)) {
-        // Know that the job already finished?
-        Job& job = get(req.jobId);
-        if (job.getState() == PAST) {
-            log(V4_VVER, "Reject req. %s : already finished\n", 
-                            toStr(req.jobId, req.requestedNodeIndex).c_str());
-            return DISCARD;
-        }
+    // A job which could be dismissed for a starving job must be a non-root leaf node
+    Job* replaceableJob = nullptr;
+    for (Job* jobPtr : _active_jobs) {
+        Job& job = *jobPtr;
+        if (job.getState() != ACTIVE || job.getJobTree().isRoot() || !job.getJobTree().isLeaf()) 
+            continue;
+        replaceableJob = jobPtr;
+        break;
     }
 
-    // Node is idle and not committed to another job
-    if (isIdle()) {
-        if (!oneshot) return ADOPT_FROM_IDLE;
-        // Oneshot request: Job must be present and suspended
-        else return (has(req.jobId) && get(req.jobId).getState() == SUSPENDED ? ADOPT_FROM_IDLE : REJECT);
+    JobPlacement::WorkerView worker;
+    worker.commSize = MyMpi::size(_comm);
+    worker.hasCommitment = _has_commitment;
+    worker.numActiveJobs = _active_jobs.size();
+    worker.numSlots = _num_slots;
+    worker.hasReplaceableLeaf = replaceableJob != nullptr;
+    auto result = JobPlacement::decideAdoption(req, oneshot, worker, getJobView(req.jobId));
+
+    if (result == JobPlacement::ADOPT_REPLACE_CURRENT) {
+        // Inform parent node of the original job  
+        log(V4_VVER, "Suspend %s ...\n", replaceableJob->toStr());
+        log(V4_VVER, "... to adopt starving %s\n", 
+                        toStr(req.jobId, req.requestedNodeIndex).c_str());
+        removedJob = replaceableJob->getId();
+        suspend(removedJob);
     }
-
-    // Request for a root node exceeded max #hops: 
-    // Possibly adopt the job while dismissing the active job
-    if (req.requestedNodeIndex == 0 && req.numHops >= 32) {
-
-        // Adoption only works if this node does not yet compute for that job
-        if (!has(req.jobId) || get(req.jobId).getState() != ACTIVE) {
-
-            // Current job must be a non-root leaf node
-            Job& job = getActive();
-            if (job.getState() == ACTIVE && !job.getJobTree().isRoot() && job.getJobTree().isLeaf()) {
-                
-                // Inform parent node of the original job  
-                log(V4_VVER, "Suspend %s ...\n", job.toStr());
-                log(V4_VVER, "... to adopt starving %s\n", 
-                                toStr(req.jobId, req.requestedNodeIndex).c_str());
-
-                removedJob = job.getId();
-                suspend(removedJob);
-                return ADOPT_REPLACE_CURRENT;
-            }
-        }
-
-        // Adoption did not work out: Defer the request if a certain #hops is reached
-        if (req.numHops % std::max(32, MyMpi::size(_comm)) == 0) {
-            log(V3_VERB, "Defer %s\n", req.toStr().c_str());
-            _deferred_requests.emplace_back(Timer::elapsedSeconds(), sender, req);
-            return DEFER;
-        }
+    if (result == JobPlacement::DEFER) {
+        _deferred_requests.emplace_back(Timer::elapsedSeconds(), sender, req);
     }
-
-    return REJECT;
+    return result;
 }
 
 void JobDatabase::reactivate(const JobRequest& req, int source) {
@@ -287,7 +213,7 @@ void JobDatabase::stop(int jobId, bool terminate) {
     if (job.getState() == SUSPENDED) job.resume();
     if (job.getState() == ACTIVE) job.stop();
     if (job.getState() == INACTIVE && terminate) {
-        if (!isIdle() && getActive().getId() == jobId) setLoad(0, jobId);
+        if (isActive(jobId)) setLoad(0, jobId);
         job.terminate();
         log(V3_VERB, "TERMINATE %s\n", job.toStr());
         if (job.hasCommitment()) uncommit(jobId);
@@ -350,7 +276,7 @@ std::vector<std::pair<JobRequest, int>>  JobDatabase::getDeferredRequestsToForwa
     
     std::vector<std::pair<JobRequest, int>> result;
     for (auto& [deferredTime, senderRank, req] : _deferred_requests) {
-        if (time - deferredTime < 1.0f) break;
+        if (time - deferredTime < JobPlacement::DEFERRAL_PERIOD) break;
         result.emplace_back(std::move(req), senderRank);
         log(V3_VERB, "Reactivate deferred %s\n", req.toStr().c_str());
     }
@@ -371,40 +297,50 @@ Job& JobDatabase::get(int id) const {
     return *_jobs.at(id);
 }
 
-Job& JobDatabase::getActive() {
-    return *_current_job;
+const std::vector<Job*>& JobDatabase::getActiveJobs() const {
+    return _active_jobs;
+}
+
+bool JobDatabase::isActive(int id) const {
+    return std::any_of(_active_jobs.begin(), _active_jobs.end(), [id](Job* job) {return job->getId() == id;});
 }
 
 std::string JobDatabase::toStr(int j, int idx) const {
     return "#" + std::to_string(j) + ":" + std::to_string(idx);
 }
 
-int JobDatabase::getLoad() const {
-    return _load;
+float JobDatabase::getLoad() const {
+    return (float)_active_jobs.size() / _num_slots;
 }
 
 void JobDatabase::setLoad(int load, int whichJobId) {
-    assert(load + _load == 1); // (load WAS 1) XOR (load BECOMES 1)
-    _load = load;
-
-    // Measure time for which worker was {idle,busy}
-    float now = Timer::elapsedSeconds();
-    //stats.add((load == 0 ? "busyTime" : "idleTime"), now - lastLoadChange);
+    assert(load == 0 || load == 1);
     assert(has(whichJobId));
+    Job* job = &get(whichJobId);
+    auto it = std::find(_active_jobs.begin(), _active_jobs.end(), job);
     if (load == 1) {
-        assert(_current_job == NULL);
-        log(V3_VERB, "LOAD 1 (+%s)\n", get(whichJobId).toStr());
-        _current_job = &get(whichJobId);
+        assert(it == _active_jobs.end() || log_return_false("%s is already active!\n", job->toStr()));
+        assert(hasFreeSlot() || log_return_false("No free slot for %s!\n", job->toStr()));
+        _active_jobs.push_back(job);
     }
     if (load == 0) {
-        assert(_current_job != NULL);
-        log(V3_VERB, "LOAD 0 (-%s)\n", get(whichJobId).toStr());
-        _current_job = NULL;
+        assert(it != _active_jobs.end() || log_return_false("%s is not active!\n", job->toStr()));
+        _active_jobs.erase(it);
     }
+    log(V3_VERB, "LOAD %i (%s%s) %i/%i slots busy\n", load, load == 1 ? "+" : "-", job->toStr(), 
+        (int)_active_jobs.size(), _num_slots);
+}
+
+int JobDatabase::getNumSlots() const {
+    return _num_slots;
+}
+
+bool JobDatabase::hasFreeSlot() const {
+    return (int)_active_jobs.size() < _num_slots;
 }
 
 bool JobDatabase::isIdle() const {
-    return _load == 0;
+    return _active_jobs.empty();
 }
 
 bool JobDatabase::isTimeForRebalancing() {
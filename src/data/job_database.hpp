@@ -8,6 +8,7 @@
 #include "util/robin_hood.hpp"
 #include "app/job.hpp"
 #include "job_transfer.hpp"
+#include "job_placement.hpp"
 #include "balancing/balancer.hpp"
 
 class JobDatabase {
@@ -25,8 +26,9 @@ private:
     robin_hood::unordered_map<int, Job*> _jobs;
     bool _has_commitment = false;
 
-    int _load;
-    Job* _current_job;
+    // Max. number of jobs which are active on this worker at the same time
+    int _num_slots;
+    std::vector<Job*> _active_jobs;
     float _last_balancing_initiation;
 
     std::list<std::tuple<float, int, JobRequest>> _deferred_requests;
@@ -53,7 +55,7 @@ public:
     const JobRequest& getCommitment(int jobId);
     void uncommit(int jobId);
 
-    enum AdoptionResult {ADOPT_FROM_IDLE, ADOPT_REPLACE_CURRENT, REJECT, DEFER, DISCARD};
+    typedef JobPlacement::AdoptionResult AdoptionResult;
     AdoptionResult tryAdopt(const JobRequest& req, bool oneshot, int sender, int& removedJob);
     
     void reactivate(const JobRequest& req, int source);
@@ -75,13 +77,22 @@ public:
 
     bool has(int id) const;
     Job& get(int id) const;
-    Job& getActive();
+    const std::vector<Job*>& getActiveJobs() const;
+    bool isActive(int id) const;
     
-    int getLoad() const;
+    // Fraction of occupied slots, in [0,1]
+    float getLoad() const;
+    // load=1: the job occupies a slot of this worker; load=0: the job releases its slot
     void setLoad(int load, int whichJobId);
+    int getNumSlots() const;
+    bool hasFreeSlot() const;
     bool isIdle() const;
 
     std::string toStr(int j, int idx) const;
+
+private:
+    // What this worker knows about the given job
+    JobPlacement::JobView getJobView(int jobId) const;
     
 };
 
@@ -58,6 +58,12 @@ public:
         push_int(_raw_data, lit);
         _f_size++;
     }
+    inline void addLiterals(const int* lits, size_t count) {
+        // Append literals to raw data in one go, update counter
+        const uint8_t* bytes = (const uint8_t*) lits;
+        _raw_data->insert(_raw_data->end(), bytes, bytes + count*sizeof(int));
+        _f_size += count;
+    }
     inline void addAssumption(int lit) {
         // Push literal to raw data, update counter
         push_int(_raw_data, lit);
@@ -86,7 +92,7 @@ public:
     bool isIncremental() const {return _incremental;}
     constexpr int getMetadataSize() const;
     int getFullTransferSize() const {return _raw_data->size();}
-    int getNumVars() {return _num_vars;}
+    int getNumVars() const {return _num_vars;}
 
     void setRootRank(int rootRank) {_root_rank = rootRank;}
     void setRevision(int revision) {_revision = revision;}
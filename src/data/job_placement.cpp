@@ -0,0 +1,183 @@
+
+#include <cmath>
+#include <algorithm>
+
+#include "job_placement.hpp"
+#include "app/job_tree.hpp"
+#include "util/permutation.hpp"
+#include "util/random.hpp"
+#include "util/logger.hpp"
+
+bool JobPlacement::isRequestObsolete(const JobRequest& req, const JobView& job, float time, float maxAge) {
+
+    // Requests for a job root never become obsolete
+    if (req.requestedNodeIndex == 0) return false;
+
+    if (job.past) {
+        // Job has already terminated!
+        log(V4_VVER, "%s : past job\n", req.toStr().c_str());
+        return true;
+    }
+    if (job.active) {
+        // Does this node KNOW that the request is already completed?
+        if (req.requestedNodeIndex == job.index
+        || (job.hasLeftChild && req.requestedNodeIndex == 2*job.index+1)
+        || (job.hasRightChild && req.requestedNodeIndex == 2*job.index+2)) {
+            // Request already completed!
+            log(V4_VVER, "%s : already completed\n", req.toStr().c_str());
+            return true;
+        }
+        // Am I the transitive parent of the request and do I know
+        // that the job's volume does not allow for this node any more?
+        if (job.volume > 0 && job.volume <= req.requestedNodeIndex
+                && JobTree::isTransitiveParentOf(job.index, req.requestedNodeIndex, job.commSize)) {
+            log(V4_VVER, "%s : new volume too small\n", req.toStr().c_str());
+            return true;
+        }
+    }
+
+    // Request timed out?
+    return maxAge > 0 && time - req.timeOfBirth >= maxAge;
+}
+
+bool JobPlacement::isAdoptionOfferObsolete(const JobRequest& req, const JobView& job, bool alreadyAccepted) {
+
+    // Requests for a job root never become obsolete
+    if (req.requestedNodeIndex == 0) return false;
+
+    // Job not known anymore: obsolete
+    if (!job.known) return true;
+
+    int leftChildIndex = 2*job.index+1;
+    int rightChildIndex = 2*job.index+2;
+    if (!job.active) {
+        // Job is not active
+        log(V4_VVER, "Req. %s : job inactive\n", req.toStr().c_str());
+        return true;
+
+    } else if (req.requestedNodeIndex != leftChildIndex && req.requestedNodeIndex != rightChildIndex) {
+        // Requested node index is not a valid child index for this job
+        log(V4_VVER, "Req. %s : not a valid child index (any more)\n", req.toStr().c_str());
+        return true;
+
+    } else if (alreadyAccepted) {
+        return false;
+
+    } else if (req.requestedNodeIndex == leftChildIndex && job.hasLeftChild) {
+        // Job already has a left child
+        log(V4_VVER, "Req. %s : already has left child\n", req.toStr().c_str());
+        return true;
+
+    } else if (req.requestedNodeIndex == rightChildIndex && job.hasRightChild) {
+        // Job already has a right child
+        log(V4_VVER, "Req. %s : already has right child\n", req.toStr().c_str());
+        return true;
+    }
+
+    return false;
+}
+
+JobPlacement::AdoptionResult JobPlacement::decideAdoption(const JobRequest& req, bool oneshot,
+        const WorkerView& worker, const JobView& job) {
+
+    // Already have another commitment?
+    if (worker.hasCommitment) return REJECT;
+
+    // Know that the job already finished?
+    if (job.past) {
+        log(V4_VVER, "Reject req. %s : already finished\n", req.toStr().c_str());
+        return DISCARD;
+    }
+
+    // Node has a free slot and is not committed to another job
+    if (worker.numActiveJobs < worker.numSlots) {
+        // A worker computes on at most one node of each job
+        if (job.active) return REJECT;
+        if (!oneshot) return ADOPT_FROM_IDLE;
+        // Oneshot request: Job must be present and suspended
+        else return job.suspended ? ADOPT_FROM_IDLE : REJECT;
+    }
+
+    // Request for a root node exceeded max #hops:
+    // Possibly adopt the job while dismissing a non-root leaf of an active job
+    if (req.requestedNodeIndex == 0 && req.numHops >= NUM_HOPS_STARVING) {
+
+        // Adoption only works if this node does not yet compute for that job
+        if (!job.active && worker.hasReplaceableLeaf) return ADOPT_REPLACE_CURRENT;
+
+        // Adoption did not work out: Defer the request if a certain #hops is reached
+        if (req.numHops % std::max(NUM_HOPS_STARVING, worker.commSize) == 0) {
+            log(V3_VERB, "Defer %s\n", req.toStr().c_str());
+            return DEFER;
+        }
+    }
+
+    return REJECT;
+}
+
+int JobPlacement::bounce(JobRequest& req, int rank, int sender, int commSize,
+        const std::vector<int>& hopDestinations, bool derandomize) {
+
+    // Increment #hops
+    req.numHops++;
+    int num = req.numHops;
+
+    // Show warning if #hops is a large power of two
+    if ((num >= 512) && ((num & (num - 1)) == 0)) {
+        log(V1_WARN, "[WARN] %s\n", req.toStr().c_str());
+    }
+
+    int nextRank;
+    if (derandomize) {
+        // Get random choice from bounce alternatives
+        if (hopDestinations.empty()) return rank;
+        nextRank = Random::choice(hopDestinations);
+        if (hopDestinations.size() > 2) {
+            // ... if possible while skipping the requesting node and the sender
+            while (nextRank == req.requestingNodeRank || nextRank == sender) {
+                nextRank = Random::choice(hopDestinations);
+            }
+        }
+    } else {
+        // Generate pseudorandom permutation of this request
+        AdjustablePermutation perm(commSize, 3 * req.jobId + 7 * req.requestedNodeIndex + 11 * req.requestingNodeRank);
+        // Fetch next index of permutation based on number of hops
+        int permIdx = req.numHops % commSize;
+        nextRank = perm.get(permIdx);
+        if (commSize > 3) {
+            // ... if possible while skipping yourself, the requesting node, and the sender
+            while (nextRank == rank || nextRank == req.requestingNodeRank || nextRank == sender) {
+                permIdx = (permIdx+1) % commSize;
+                nextRank = perm.get(permIdx);
+            }
+        }
+    }
+    return nextRank;
+}
+
+int JobPlacement::getDemand(int commSize, float activeTime, float growthPeriod, bool continuousGrowth, int maxDemand) {
+
+    int demand;
+    if (growthPeriod <= 0) {
+        // Immediate growth
+        demand = commSize;
+    } else if (activeTime < 0) {
+        demand = 1;
+    } else {
+        // Number of growth periods so far
+        float numPeriods = activeTime/growthPeriod;
+        if (!continuousGrowth) {
+            // Discrete periodic growth
+            numPeriods = std::floor(numPeriods);
+        }
+        // d(0) := 1; d := 2d+1 every <growthPeriod> seconds
+        // (computed in floating point such that it cannot overflow)
+        demand = (int) std::min((double)commSize, std::pow(2.0, numPeriods + 1) - 1);
+    }
+
+    // Limit demand if desired
+    if (maxDemand > 0) {
+        demand = std::min(demand, maxDemand);
+    }
+    return demand;
+}
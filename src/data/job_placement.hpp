@@ -0,0 +1,76 @@
+
+#ifndef DOMPASCH_MALLOB_JOB_PLACEMENT_HPP
+#define DOMPASCH_MALLOB_JOB_PLACEMENT_HPP
+
+#include <vector>
+
+#include "data/job_transfer.hpp"
+
+/*
+Decision rules of placing job nodes on workers: whether a job request is obsolete,
+adopted, deferred or bounced on (and where to), whether a parent still wants an
+offered adoption, when a job tree grows or shrinks, and how the demand of a job
+evolves over time. The rules only depend on what a worker knows locally, which the
+caller describes by a JobView and a WorkerView. They are used by the workers
+(Worker, JobDatabase, Job) as well as by the offline simulator (src/sim), so that
+a simulation takes the same decisions as an actual run.
+*/
+class JobPlacement {
+
+public:
+    // Number of hops after which a request for a job root may displace a leaf of another job
+    static const int NUM_HOPS_STARVING = 32;
+    // Time (seconds) a deferred request rests before it is bounced on
+    static constexpr float DEFERRAL_PERIOD = 1.0f;
+
+    // What a worker knows about a particular job
+    struct JobView {
+        int commSize = 1;
+        // The worker holds a current or former node of the job
+        bool known = false;
+        // ... and its state
+        bool past = false;
+        bool active = false;
+        bool suspended = false;
+        // The worker's node of the job and its knowledge of the job tree
+        int index = -1;
+        int volume = 0;
+        bool hasLeftChild = false;
+        bool hasRightChild = false;
+    };
+
+    // What a worker knows about itself
+    struct WorkerView {
+        int commSize = 1;
+        bool hasCommitment = false;
+        int numActiveJobs = 0;
+        int numSlots = 1;
+        // One of the active jobs is a non-root leaf which could make room for a starving job
+        bool hasReplaceableLeaf = false;
+    };
+
+    enum AdoptionResult {ADOPT_FROM_IDLE, ADOPT_REPLACE_CURRENT, REJECT, DEFER, DISCARD};
+
+    // Whether a worker which receives the request can discard it (maxAge <= 0: no timeout)
+    static bool isRequestObsolete(const JobRequest& req, const JobView& job, float time, float maxAge);
+    // Whether the requesting node (with the given view of the job) does not want
+    // the requested node any more
+    static bool isAdoptionOfferObsolete(const JobRequest& req, const JobView& job, bool alreadyAccepted);
+    // How a worker reacts to a non-obsolete request
+    static AdoptionResult decideAdoption(const JobRequest& req, bool oneshot,
+            const WorkerView& worker, const JobView& job);
+
+    // Increments the request's number of hops and returns the rank to bounce it to next
+    static int bounce(JobRequest& req, int rank, int sender, int commSize,
+            const std::vector<int>& hopDestinations, bool derandomize);
+
+    // A job node requests a child at the given index if it has no such child yet
+    static bool isChildWanted(int childIndex, int volume) {return childIndex < volume;}
+    // A non-root job node leaves its job if the volume does not include it any more
+    static bool isNodeLeaving(int index, int volume) {return index > 0 && index >= volume;}
+
+    // Demand of a job whose root has been active for <activeTime> seconds (< 0: not yet active)
+    static int getDemand(int commSize, float activeTime, float growthPeriod, bool continuousGrowth, int maxDemand);
+};
+
+#endif
@@ -130,7 +130,10 @@ struct JobMessage : public Serializable {
 public:
     std::vector<uint8_t> serialize() const override {
         int size = 3*sizeof(int) + payload.size()*sizeof(int);
-        std::vector<uint8_t> packed(size);
+        // Reserve room for the tag which MyMpi appends to anytime messages
+        std::vector<uint8_t> packed;
+        packed.reserve(size + sizeof(int));
+        packed.resize(size);
 
         int i = 0, n;
         n = sizeof(int); memcpy(packed.data()+i, &jobId, n); i += n;
@@ -64,7 +64,8 @@ int main(int argc, char *argv[]) {
     Parameters params;
     params.init(argc, argv);
     Logger::init(rank, params.getIntParam("v"), params.isNotNull("colors"), 
-            /*quiet=*/params.isNotNull("q"), /*cPrefix=*/params.isNotNull("mono"), params.getParam("log"));
+            /*quiet=*/params.isNotNull("q"), /*cPrefix=*/params.isNotNull("mono"), params.getParam("log"), 
+            /*asynchronous=*/params.isNotNull("alog"));
     
     MyMpi::setOptions(params);
 
@@ -0,0 +1,537 @@
+
+#include <climits>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#include "balancing_simulator.hpp"
+#include "util/random.hpp"
+#include "util/logger.hpp"
+
+std::vector<BalancingSimulator::ScenarioJob> BalancingSimulator::readScenario(const std::string& filename) {
+
+    std::vector<ScenarioJob> jobs;
+    std::ifstream in(filename);
+    if (!in.is_open()) {
+        log(V0_CRIT, "ERROR: Could not open scenario file \"%s\"\n", filename.c_str());
+        return jobs;
+    }
+
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        lineNo++;
+        // Skip empty lines and comments
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') continue;
+
+        std::istringstream lineStream(line);
+        ScenarioJob job;
+        if (!(lineStream >> job.id >> job.arrival >> job.priority >> job.file)) {
+            log(V1_WARN, "[WARN] %s:%i : malformed scenario line, skipping\n", filename.c_str(), lineNo);
+            continue;
+        }
+        std::string flag;
+        if (lineStream >> flag) job.incremental = (flag == "i");
+        jobs.push_back(job);
+    }
+    return jobs;
+}
+
+BalancingSimulator::BalancingSimulator(Parameters& params, int numRanks, float latency, float workPerJob) :
+        _params(params), _num_ranks(numRanks), _latency(latency), _work_per_job(workPerJob),
+        _slots_per_rank(std::max(1, params.getIntParam("ajpw"))),
+        // Threads are split evenly among the jobs which share a worker
+        _threads_per_node(std::max(1, params.getIntParam("t") / _slots_per_rank)),
+        _derandomize(params.isNotNull("derandomize")), _request_timeout(params.getFloatParam("rto")),
+        _ranks(numRanks) {
+
+    // Derandomized hop graph, as built by each worker
+    int numBounceAlternatives = std::min(_params.getIntParam("ba"), _num_ranks / 2);
+    for (int rank = 0; rank < _num_ranks; rank++) {
+        _hop_destinations.push_back(numBounceAlternatives == 0 ? std::vector<int>() :
+                AdjustablePermutation::createExpanderGraph(_num_ranks, numBounceAlternatives, rank));
+    }
+
+    // A balancing is reduced up and then broadcast down a binary tree over all ranks
+    int depth = 0;
+    while ((1 << depth) < _num_ranks) depth++;
+    _balancing_latency = 2 * depth * _latency;
+}
+
+void BalancingSimulator::run(const std::vector<ScenarioJob>& jobs, float timeLimit) {
+
+    for (const auto& desc : jobs) {
+        if (_jobs.count(desc.id)) {
+            log(V1_WARN, "[WARN] Duplicate job ID %i in scenario, skipping\n", desc.id);
+            continue;
+        }
+        auto job = std::unique_ptr<SimJob>(new SimJob(desc, _num_ranks));
+        if (job->desc.priority <= 0 || job->desc.priority > 1) {
+            log(V1_WARN, "[WARN] Priority %.3f of #%i is not in (0,1], clamping\n", job->desc.priority, desc.id);
+            job->desc.priority = std::max(0.01f, std::min(1.0f, job->desc.priority));
+        }
+        if (_params.isNotNull("jjp")) {
+            // Jitter job priority
+            job->desc.priority *= 0.99 + 0.01 * Random::rand();
+        }
+        job->stats.id = desc.id;
+        job->stats.arrival = desc.arrival;
+        _jobs[desc.id] = std::move(job);
+        _num_unfinished_jobs++;
+        schedule(desc.arrival, ARRIVAL, -1, desc.id);
+        float wallclockLimit = _params.getFloatParam("job-wallclock-limit");
+        if (wallclockLimit > 0) schedule(desc.arrival + wallclockLimit, JOB_DONE, -1, desc.id, -1, -1);
+    }
+    log(V2_INFO, "SIM %i ranks x %i slots, %i jobs, latency=%.6fs, balancing latency=%.6fs\n",
+            _num_ranks, _slots_per_rank, _num_unfinished_jobs, _latency, _balancing_latency);
+
+    schedule(0, BALANCING_TICK, -1);
+    schedule(0, SAMPLE, -1);
+
+    while (!_events.empty() && _num_unfinished_jobs > 0) {
+        SimEvent ev = _events.top();
+        if (timeLimit > 0 && ev.time > timeLimit) {
+            _time = timeLimit;
+            break;
+        }
+        _events.pop();
+        _time = ev.time;
+        process(ev);
+    }
+
+    // Finalize statistics
+    addBusySlots(0);
+    for (auto& [jobId, job] : _jobs) if (!job->done) updateProgress(*job);
+}
+
+void BalancingSimulator::schedule(double time, SimEventType type, int rank, int jobId, int index, int value,
+        const JobRequest& req) {
+    SimEvent ev;
+    ev.time = time;
+    ev.sequence = _sequence++;
+    ev.type = type;
+    ev.rank = rank;
+    ev.sender = -1;
+    ev.jobId = jobId;
+    ev.index = index;
+    ev.value = value;
+    ev.req = req;
+    _events.push(ev);
+}
+
+void BalancingSimulator::sendRequest(int from, int to, const JobRequest& req) {
+    SimEvent ev;
+    ev.time = _time + _latency;
+    ev.sequence = _sequence++;
+    ev.type = REQUEST;
+    ev.rank = to;
+    ev.sender = from;
+    ev.jobId = req.jobId;
+    ev.index = req.requestedNodeIndex;
+    ev.value = 0;
+    ev.req = req;
+    _events.push(ev);
+}
+
+void BalancingSimulator::process(SimEvent& ev) {
+    switch (ev.type) {
+    case ARRIVAL: handleArrival(ev); break;
+    case REQUEST: handleRequest(ev); break;
+    case DEFERRED_REQUEST: handleDeferredRequest(ev); break;
+    case ADOPTION: handleAdoption(ev); break;
+    case VOLUME_UPDATE: handleVolumeUpdate(ev); break;
+    case CHILD_LEFT: handleChildLeft(ev); break;
+    case BALANCING_TICK: handleBalancingTick(); break;
+    case BALANCING_DONE: handleBalancingDone(); break;
+    case JOB_DONE: handleJobDone(ev); break;
+    case RELEASE: handleRelease(ev); break;
+    case SAMPLE: handleSample(); break;
+    }
+}
+
+void BalancingSimulator::handleArrival(SimEvent& ev) {
+    SimJob& job = *_jobs[ev.jobId];
+    // The client sends the root request to the job's canonical initial rank
+    int rank = job.permutation.get(0);
+    JobRequest req(ev.jobId, /*rootRank=*/-1, /*requestingNodeRank=*/-1, /*requestedNodeIndex=*/0, _time);
+    log(V3_VERB, "SIM t=%.3f introduce #%i at [%i]\n", _time, ev.jobId, rank);
+    sendRequest(-1, rank, req);
+}
+
+void BalancingSimulator::handleRequest(SimEvent& ev) {
+
+    JobRequest& req = ev.req;
+    if (JobPlacement::isRequestObsolete(req, getJobView(ev.rank, req.jobId), _time, _request_timeout)) {
+        log(V5_DEBG, "SIM t=%.3f [%i] discard %s\n", _time, ev.rank, req.toStr().c_str());
+        return;
+    }
+
+    SimRank& rank = _ranks[ev.rank];
+    auto result = JobPlacement::decideAdoption(req, /*oneshot=*/false, getWorkerView(ev.rank), 
+            getJobView(ev.rank, req.jobId));
+
+    if (result == JobPlacement::ADOPT_REPLACE_CURRENT) {
+        // Dismiss a non-root leaf of another job
+        for (const auto& node : rank.nodes) {
+            if (node.releasing || node.index == 0) continue;
+            const SimJob& currentJob = *_jobs[node.jobId];
+            if (currentJob.nodes.count(2*node.index+1) || currentJob.nodes.count(2*node.index+2)) continue;
+            log(V4_VVER, "SIM t=%.3f [%i] suspend #%i:%i to adopt starving #%i\n",
+                    _time, ev.rank, node.jobId, node.index, req.jobId);
+            leave(ev.rank, node.jobId, /*notifyParent=*/true);
+            break;
+        }
+    }
+
+    if (result == JobPlacement::ADOPT_FROM_IDLE || result == JobPlacement::ADOPT_REPLACE_CURRENT) {
+        // Commit, offer adoption to the requesting node and wait for its acceptance
+        rank.committed = true;
+        schedule(_time + 2*_latency, ADOPTION, ev.rank, req.jobId, req.requestedNodeIndex, 0, req);
+    } else if (result == JobPlacement::DEFER) {
+        // Continue bouncing the request later
+        ev.time = _time + JobPlacement::DEFERRAL_PERIOD;
+        ev.sequence = _sequence++;
+        ev.type = DEFERRED_REQUEST;
+        _events.push(ev);
+    } else if (result == JobPlacement::REJECT) {
+        bounce(req, ev.rank, ev.sender);
+    }
+}
+
+void BalancingSimulator::handleDeferredRequest(SimEvent& ev) {
+    bounce(ev.req, ev.rank, ev.sender);
+}
+
+void BalancingSimulator::handleAdoption(SimEvent& ev) {
+
+    SimRank& rank = _ranks[ev.rank];
+    rank.committed = false;
+    SimJob& job = *_jobs[ev.jobId];
+    int index = ev.index;
+
+    // Does the requesting node accept the adoption offer?
+    // (a terminated job adopts no more nodes, and the client accepts a single root)
+    bool obsolete = job.done || (index == 0 && job.nodes.count(0));
+    if (obsolete || JobPlacement::isAdoptionOfferObsolete(ev.req, 
+            getJobView(ev.req.requestingNodeRank, ev.jobId), /*alreadyAccepted=*/false)) {
+        log(V5_DEBG, "SIM t=%.3f [%i] obsolete offer for #%i:%i\n", _time, ev.rank, ev.jobId, index);
+        return;
+    }
+
+    updateProgress(job);
+    int volume = index == 0 ? 1 : _ranks[job.nodes.at((index-1)/2)].find(ev.jobId)->volume;
+    rank.nodes.push_back(SimNode{ev.jobId, index, volume});
+    job.nodes[index] = ev.rank;
+    addBusySlots(1);
+    scheduleCompletion(job);
+
+    int hops = ev.req.numHops;
+    job.stats.numAdoptions++;
+    job.stats.sumOfHops += hops;
+    job.stats.maxHops = std::max(job.stats.maxHops, hops);
+    if (index == 0) {
+        job.stats.timeOfRootAdoption = _time;
+        job.stats.rootHops = hops;
+    }
+    job.stats.maxVolume = std::max(job.stats.maxVolume, (int)job.nodes.size());
+    log(V4_VVER, "SIM t=%.3f [%i] adopt #%i:%i hops=%i\n", _time, ev.rank, ev.jobId, index, hops);
+
+    growOrShrink(ev.rank, ev.jobId);
+}
+
+void BalancingSimulator::handleVolumeUpdate(SimEvent& ev) {
+    SimNode* node = _ranks[ev.rank].find(ev.jobId);
+    if (node == nullptr || node->index != ev.index || node->releasing) return;
+    node->volume = ev.value;
+    growOrShrink(ev.rank, ev.jobId);
+}
+
+void BalancingSimulator::handleChildLeft(SimEvent& ev) {
+    SimNode* node = _ranks[ev.rank].find(ev.jobId);
+    if (node == nullptr || node->releasing) return;
+    SimJob& job = *_jobs[ev.jobId];
+    int index = ev.index;
+
+    // Find a replacement for the defected child if necessary
+    if (!job.nodes.count(index) && JobPlacement::isChildWanted(index, node->volume)) {
+        const auto& destinations = _hop_destinations[ev.rank];
+        int nextRank;
+        if (_derandomize) nextRank = destinations.empty() ? ev.rank : Random::choice(destinations);
+        else {
+            // Random rank other than this one
+            nextRank = (int) (Random::rand() * (_num_ranks-1));
+            if (nextRank >= ev.rank) nextRank++;
+            if (nextRank >= _num_ranks) nextRank = ev.rank;
+        }
+        JobRequest req(ev.jobId, job.nodes.count(0) ? job.nodes.at(0) : -1, ev.rank, index, _time);
+        sendRequest(ev.rank, nextRank, req);
+    }
+}
+
+void BalancingSimulator::handleBalancingTick() {
+
+    // Each job root inserts an event if there is something novel about its job
+    for (auto& [jobId, jobPtr] : _jobs) {
+        SimJob& job = *jobPtr;
+        if (job.done || !job.nodes.count(0)) continue;
+        Event ev({jobId, job.epoch, std::max(1, getDemand(job)), job.desc.priority});
+        if (!_states.contains(jobId)
+                || ev.demand != _states.at(jobId).demand
+                || ev.priority != _states.at(jobId).priority) {
+            if (_diffs.insertIfNovel(ev)) job.epoch++;
+        }
+    }
+
+    // Initiate a balancing, if applicable
+    float period = _params.getFloatParam("p");
+    if (!_diffs.isEmpty() && !_balancing_in_progress && _time - _last_balancing >= period) {
+        _balancing_in_flight = _diffs;
+        _balancing_in_progress = true;
+        _last_balancing = _time;
+        schedule(_time + _balancing_latency, BALANCING_DONE, -1);
+    }
+
+    schedule(_time + std::max(0.001f, period), BALANCING_TICK, -1);
+}
+
+void BalancingSimulator::handleBalancingDone() {
+
+    _balancing_in_progress = false;
+    bool anyChange = _states.updateBy(_balancing_in_flight);
+    _diffs.filterBy(_states);
+    if (!anyChange) return;
+    _balancing_epoch++;
+    _num_balancings++;
+
+    // Forget terminated jobs
+    std::vector<int> terminated;
+    for (const auto& ev : _states.getEntries()) {
+        if (ev.epoch == INT_MAX) terminated.push_back(ev.jobId);
+    }
+    for (int jobId : terminated) {
+        _states.remove(jobId);
+        _diffs.remove(jobId);
+    }
+
+    auto volumes = EventDrivenBalancer::computeVolumes(_states, _num_ranks * _slots_per_rank, _params.getFloatParam("l"),
+            _params.getParam("r"), _balancing_epoch, V5_DEBG);
+
+    // Each job root applies its new volume and propagates it down its job tree
+    for (const auto& [jobId, volume] : volumes) {
+        if (volume < 1 || !_jobs.count(jobId)) continue;
+        SimJob& job = *_jobs[jobId];
+        if (job.done || !job.nodes.count(0)) continue;
+        int root = job.nodes.at(0);
+        SimNode* rootNode = _ranks[root].find(jobId);
+        if (rootNode->volume != volume) {
+            log(V4_VVER, "SIM t=%.3f #%i : update v=%i\n", _time, jobId, volume);
+        }
+        rootNode->volume = volume;
+        growOrShrink(root, jobId);
+    }
+}
+
+void BalancingSimulator::handleJobDone(SimEvent& ev) {
+
+    SimJob& job = *_jobs[ev.jobId];
+    if (job.done) return;
+    bool timeout = ev.value == -1;
+    if (!timeout && ev.value != job.progressVersion) return; // outdated prediction
+
+    updateProgress(job);
+    job.done = true;
+    job.stats.timeOfCompletion = _time;
+    _num_unfinished_jobs--;
+    log(V2_INFO, "SIM t=%.3f #%i %s resp=%.3f\n", _time, ev.jobId, timeout ? "timeout" : "done",
+            _time - job.desc.arrival);
+
+    // Termination travels down the job tree
+    for (const auto& [index, rank] : job.nodes) {
+        int depth = 0;
+        while ((1 << (depth+1)) <= index+1) depth++;
+        _ranks[rank].find(ev.jobId)->releasing = true;
+        schedule(_time + (depth+1) * _latency, RELEASE, rank, ev.jobId, index);
+    }
+    job.nodes.clear();
+
+    // Signal the termination to the balancing
+    if (_states.contains(ev.jobId) || _diffs.contains(ev.jobId)) {
+        _diffs.insertIfNovel(Event({ev.jobId, /*epoch=*/INT_MAX, /*demand=*/0, /*priority=*/0}));
+    }
+}
+
+void BalancingSimulator::handleRelease(SimEvent& ev) {
+    SimRank& rank = _ranks[ev.rank];
+    SimNode* node = rank.find(ev.jobId);
+    if (node == nullptr || node->index != ev.index) return;
+    rank.nodes.erase(rank.nodes.begin() + (node - rank.nodes.data()));
+    rank.pastJobs.insert(ev.jobId);
+    addBusySlots(-1);
+}
+
+void BalancingSimulator::handleSample() {
+
+    std::string volumes = "";
+    for (const auto& [jobId, job] : _jobs) {
+        if (job->done || job->nodes.empty()) continue;
+        int volume = job->nodes.count(0) ? _ranks[job->nodes.at(0)].find(jobId)->volume : 0;
+        volumes += " #" + std::to_string(jobId) + ":" + std::to_string(job->nodes.size())
+                + "/" + std::to_string(volume);
+    }
+    log(V2_INFO, "SIM t=%.3f util=%.3f jobs_left=%i vols={%s }\n", _time,
+            (float)_num_busy_slots / (_num_ranks * _slots_per_rank), _num_unfinished_jobs, volumes.c_str());
+
+    schedule(_time + std::max(0.001f, _params.getFloatParam("sim-sample-period")), SAMPLE, -1);
+}
+
+JobPlacement::JobView BalancingSimulator::getJobView(int rankIdx, int jobId) {
+
+    JobPlacement::JobView view;
+    view.commSize = _num_ranks;
+    if (rankIdx < 0) return view;
+    SimRank& rank = _ranks[rankIdx];
+    if (rank.pastJobs.count(jobId)) {
+        view.known = true;
+        view.past = true;
+        return view;
+    }
+    const SimNode* node = rank.find(jobId);
+    if (node == nullptr) return view;
+
+    // Each job node knows its own children
+    const SimJob& job = *_jobs.at(jobId);
+    view.known = true;
+    view.active = true;
+    view.index = node->index;
+    view.volume = node->volume;
+    view.hasLeftChild = job.nodes.count(2*node->index+1);
+    view.hasRightChild = job.nodes.count(2*node->index+2);
+    return view;
+}
+
+JobPlacement::WorkerView BalancingSimulator::getWorkerView(int rankIdx) {
+
+    SimRank& rank = _ranks[rankIdx];
+    JobPlacement::WorkerView view;
+    view.commSize = _num_ranks;
+    view.hasCommitment = rank.committed;
+    view.numActiveJobs = rank.nodes.size();
+    view.numSlots = _slots_per_rank;
+    for (const auto& node : rank.nodes) {
+        if (node.releasing || node.index == 0) continue;
+        const SimJob& job = *_jobs.at(node.jobId);
+        if (!job.nodes.count(2*node.index+1) && !job.nodes.count(2*node.index+2)) 
+            view.hasReplaceableLeaf = true;
+    }
+    return view;
+}
+
+void BalancingSimulator::bounce(JobRequest& req, int rank, int sender) {
+    int nextRank = JobPlacement::bounce(req, rank, sender, _num_ranks, _hop_destinations[rank], _derandomize);
+    sendRequest(rank, nextRank, req);
+}
+
+void BalancingSimulator::growOrShrink(int rankIdx, int jobId) {
+
+    SimNode& node = *_ranks[rankIdx].find(jobId);
+    SimJob& job = *_jobs[jobId];
+    int index = node.index;
+    int volume = node.volume;
+
+    for (int childIndex : {2*index+1, 2*index+2}) {
+        if (job.nodes.count(childIndex)) {
+            // Propagate volume update
+            schedule(_time + _latency, VOLUME_UPDATE, job.nodes.at(childIndex), jobId, childIndex, volume);
+        } else if (JobPlacement::isChildWanted(childIndex, volume)) {
+            // Grow: request the child at its canonical rank
+            JobRequest req(jobId, job.nodes.count(0) ? job.nodes.at(0) : -1, rankIdx, childIndex, _time);
+            sendRequest(rankIdx, job.permutation.get(childIndex), req);
+        }
+    }
+
+    // Shrink if necessary
+    if (JobPlacement::isNodeLeaving(index, volume)) leave(rankIdx, jobId, /*notifyParent=*/true);
+}
+
+void BalancingSimulator::leave(int rankIdx, int jobId, bool notifyParent) {
+
+    SimRank& rank = _ranks[rankIdx];
+    SimNode* node = rank.find(jobId);
+    SimJob& job = *_jobs[jobId];
+    int index = node->index;
+    log(V5_DEBG, "SIM t=%.3f [%i] leave #%i:%i\n", _time, rankIdx, jobId, index);
+
+    updateProgress(job);
+    job.nodes.erase(index);
+    scheduleCompletion(job);
+
+    if (notifyParent && index > 0 && job.nodes.count((index-1)/2)) {
+        schedule(_time + _latency, CHILD_LEFT, job.nodes.at((index-1)/2), jobId, index);
+    }
+    rank.nodes.erase(rank.nodes.begin() + (node - rank.nodes.data()));
+    addBusySlots(-1);
+}
+
+int BalancingSimulator::getDemand(const SimJob& job) const {
+    return JobPlacement::getDemand(_num_ranks, _time - job.stats.timeOfRootAdoption,
+            _params.getFloatParam("g"), _params.isNotNull("cg"), _params.getIntParam("md"));
+}
+
+void BalancingSimulator::updateProgress(SimJob& job) {
+    double elapsed = _time - job.lastProgressUpdate;
+    job.workDone += elapsed * job.nodes.size() * _threads_per_node;
+    job.stats.volumeIntegral += elapsed * job.nodes.size();
+    job.lastProgressUpdate = _time;
+}
+
+void BalancingSimulator::scheduleCompletion(SimJob& job) {
+    // Invalidate the previous prediction
+    job.progressVersion++;
+    job.stats.maxVolume = std::max(job.stats.maxVolume, (int)job.nodes.size());
+    if (job.nodes.empty()) return;
+    double remaining = std::max(0.0, _work_per_job - job.workDone);
+    schedule(_time + remaining / (job.nodes.size() * _threads_per_node), JOB_DONE, -1, job.desc.id, -1,
+            job.progressVersion);
+}
+
+void BalancingSimulator::addBusySlots(int delta) {
+    _busy_integral += _num_busy_slots * (_time - _last_busy_update);
+    _last_busy_update = _time;
+    _num_busy_slots += delta;
+}
+
+std::vector<BalancingSimulator::JobStats> BalancingSimulator::getJobStats() const {
+    std::vector<JobStats> stats;
+    for (const auto& [jobId, job] : _jobs) stats.push_back(job->stats);
+    return stats;
+}
+
+void BalancingSimulator::logReport() const {
+
+    int numDone = 0;
+    double sumOfResponseTimes = 0;
+    int numAdoptions = 0, sumOfHops = 0, maxHops = 0;
+    for (const auto& stats : getJobStats()) {
+        if (stats.arrival > _time) continue; // did not arrive yet
+        bool done = stats.timeOfCompletion >= 0;
+        float end = done ? stats.timeOfCompletion : _time;
+        float activeTime = stats.timeOfRootAdoption >= 0 ? end - stats.timeOfRootAdoption : 0;
+        log(V2_INFO, "SIM #%i arv=%.3f start=%.3f end=%.3f resp=%.3f maxvol=%i meanvol=%.2f adoptions=%i hops={root=%i avg=%.2f max=%i}%s\n",
+            stats.id, stats.arrival, stats.timeOfRootAdoption, end, end - stats.arrival,
+            stats.maxVolume, activeTime > 0 ? stats.volumeIntegral / activeTime : 0.0, stats.numAdoptions,
+            stats.rootHops, stats.numAdoptions > 0 ? (float)stats.sumOfHops / stats.numAdoptions : 0.0f,
+            stats.maxHops, done ? "" : " (unfinished)");
+        if (done) {
+            numDone++;
+            sumOfResponseTimes += stats.timeOfCompletion - stats.arrival;
+        }
+        numAdoptions += stats.numAdoptions;
+        sumOfHops += stats.sumOfHops;
+        maxHops = std::max(maxHops, stats.maxHops);
+    }
+    log(V2_INFO, "SIM summary t=%.3f done=%i/%i mean_resp=%.3f util=%.3f balancings=%i adoptions=%i hops={avg=%.2f max=%i}\n",
+        _time, numDone, (int)_jobs.size(), numDone > 0 ? sumOfResponseTimes / numDone : 0.0,
+        getMeanUtilization(), _num_balancings, numAdoptions,
+        numAdoptions > 0 ? (float)sumOfHops / numAdoptions : 0.0f, maxHops);
+}
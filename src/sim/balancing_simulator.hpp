@@ -0,0 +1,184 @@
+
+#ifndef DOMPASCH_MALLOB_BALANCING_SIMULATOR_HPP
+#define DOMPASCH_MALLOB_BALANCING_SIMULATOR_HPP
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <map>
+#include <set>
+#include <memory>
+
+#include "util/params.hpp"
+#include "util/permutation.hpp"
+#include "data/job_transfer.hpp"
+#include "data/job_placement.hpp"
+#include "balancing/event_driven_balancer.hpp"
+
+/*
+Single-process discrete-event simulation of the scheduling layer: job arrivals
+from a scenario file, event-driven balancing (using the actual volume computation
+of the EventDrivenBalancer), growing and shrinking of job trees, and the search
+for free worker slots by bouncing job requests. All placement decisions (discarding,
+adopting, deferring and bouncing requests, accepting adoptions, growing, shrinking,
+job demands) are taken by the same JobPlacement rules as in the workers, based on
+the simulated local knowledge of each rank. Each rank offers -ajpw job slots.
+Jobs do not solve anything; each job is finished as soon as it has received
+a fixed amount of CPU time (-sim-work), which it accumulates with t/ajpw CPUs per
+active job node. Each message takes -sim-latency seconds from sender to receiver.
+Dormant children (oneshot requests) and job descriptions are not simulated.
+*/
+class BalancingSimulator {
+
+public:
+    // One line "ID Arv Prio File [i]" of a scenario file
+    struct ScenarioJob {
+        int id;
+        float arrival;
+        float priority;
+        std::string file;
+        bool incremental = false;
+    };
+    static std::vector<ScenarioJob> readScenario(const std::string& filename);
+
+    struct JobStats {
+        int id;
+        float arrival;
+        float timeOfRootAdoption = -1;
+        float timeOfCompletion = -1;
+        int maxVolume = 0;
+        double volumeIntegral = 0;
+        int numAdoptions = 0;
+        int sumOfHops = 0;
+        int maxHops = 0;
+        int rootHops = 0;
+    };
+
+private:
+    enum SimEventType {ARRIVAL, REQUEST, DEFERRED_REQUEST, ADOPTION, VOLUME_UPDATE, CHILD_LEFT, BALANCING_TICK,
+        BALANCING_DONE, JOB_DONE, RELEASE, SAMPLE};
+    struct SimEvent {
+        double time;
+        unsigned long sequence;
+        SimEventType type;
+        int rank; // receiving rank
+        int sender;
+        int jobId;
+        int index;
+        int value;
+        JobRequest req;
+    };
+    struct SimEventComparator {
+        bool operator()(const SimEvent& left, const SimEvent& right) const {
+            if (left.time != right.time) return left.time > right.time;
+            return left.sequence > right.sequence;
+        }
+    };
+
+    // A job node computed on by some rank
+    struct SimNode {
+        int jobId;
+        int index;
+        int volume; // volume of the job as known by this node
+        bool releasing = false; // job terminated, node is about to free its slot
+    };
+
+    struct SimRank {
+        std::vector<SimNode> nodes; // one per occupied slot
+        bool committed = false;
+        std::set<int> pastJobs; // terminated jobs this rank has computed on
+        SimNode* find(int jobId) {
+            for (auto& node : nodes) if (node.jobId == jobId) return &node;
+            return nullptr;
+        }
+    };
+
+    struct SimJob {
+        ScenarioJob desc;
+        AdjustablePermutation permutation;
+        std::map<int, int> nodes; // job tree index -> rank
+        int epoch = 1;
+        double workDone = 0;
+        double lastProgressUpdate = 0;
+        int progressVersion = 0;
+        bool done = false;
+        JobStats stats;
+        SimJob(const ScenarioJob& desc, int numRanks) : desc(desc), permutation(numRanks, desc.id) {}
+    };
+
+    Parameters& _params;
+    const int _num_ranks;
+    const float _latency;
+    const float _work_per_job;
+    const int _slots_per_rank;
+    const int _threads_per_node;
+    const bool _derandomize;
+    const float _request_timeout;
+
+    double _time = 0;
+    unsigned long _sequence = 0;
+    std::priority_queue<SimEvent, std::vector<SimEvent>, SimEventComparator> _events;
+
+    std::vector<SimRank> _ranks;
+    std::vector<std::vector<int>> _hop_destinations;
+    std::map<int, std::unique_ptr<SimJob>> _jobs;
+    int _num_unfinished_jobs = 0;
+
+    // Balancing state
+    EventMap _states;
+    EventMap _diffs;
+    EventMap _balancing_in_flight;
+    double _last_balancing = -1;
+    bool _balancing_in_progress = false;
+    int _balancing_epoch = 0;
+    int _num_balancings = 0;
+    float _balancing_latency;
+
+    // Utilization statistics
+    int _num_busy_slots = 0;
+    double _busy_integral = 0;
+    double _last_busy_update = 0;
+
+public:
+    BalancingSimulator(Parameters& params, int numRanks, float latency, float workPerJob);
+
+    // Simulates the provided jobs until all of them are done or until timeLimit (if positive)
+    void run(const std::vector<ScenarioJob>& jobs, float timeLimit);
+
+    std::vector<JobStats> getJobStats() const;
+    double getMeanUtilization() const {return _time <= 0 ? 0 : _busy_integral / _time / (_num_ranks * _slots_per_rank);}
+    double getSimulatedTime() const {return _time;}
+    int getNumBalancings() const {return _num_balancings;}
+    void logReport() const;
+
+private:
+    void schedule(double time, SimEventType type, int rank, int jobId = -1, int index = -1, int value = 0,
+            const JobRequest& req = JobRequest());
+    void sendRequest(int from, int to, const JobRequest& req);
+    void process(SimEvent& ev);
+
+    void handleArrival(SimEvent& ev);
+    void handleRequest(SimEvent& ev);
+    void handleDeferredRequest(SimEvent& ev);
+    void handleAdoption(SimEvent& ev);
+    void handleVolumeUpdate(SimEvent& ev);
+    void handleChildLeft(SimEvent& ev);
+    void handleBalancingTick();
+    void handleBalancingDone();
+    void handleJobDone(SimEvent& ev);
+    void handleRelease(SimEvent& ev);
+    void handleSample();
+
+    JobPlacement::JobView getJobView(int rank, int jobId);
+    JobPlacement::WorkerView getWorkerView(int rank);
+    void bounce(JobRequest& req, int rank, int sender);
+    void growOrShrink(int rank, int jobId);
+    void leave(int rank, int jobId, bool notifyParent);
+
+    int getDemand(const SimJob& job) const;
+    void updateProgress(SimJob& job);
+    void scheduleCompletion(SimJob& job);
+    void addBusySlots(int delta);
+};
+
+#endif
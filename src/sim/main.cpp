@@ -0,0 +1,62 @@
+
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "util/sys/timer.hpp"
+#include "util/logger.hpp"
+#include "util/random.hpp"
+#include "util/params.hpp"
+#include "sim/balancing_simulator.hpp"
+
+/*
+Offline simulator: replays a scenario file through the balancing and
+job placement logic of mallob without MPI, within a single process.
+Usage: mallob_sim -sim-scenario=<file> [-sim-ranks=<num>] [-sim-latency=<secs>]
+       [-sim-work=<secs>] [-g=..] [-l=..] [-p=..] [other options]
+*/
+int main(int argc, char *argv[]) {
+
+    Timer::init();
+
+    Parameters params;
+    params.init(argc, argv);
+    Logger::init(0, params.getIntParam("v"), params.isNotNull("colors"),
+            /*quiet=*/params.isNotNull("q"), /*cPrefix=*/false, params.getParam("log"));
+
+    if (params.isSet("h") || params.isSet("help")) {
+        params.printUsage();
+        exit(0);
+    }
+    params.printParams();
+
+    std::string scenario = params.getParam("sim-scenario");
+    if (scenario.empty()) {
+        log(V0_CRIT, "ERROR: No scenario provided (-sim-scenario=<file>)\n");
+        exit(1);
+    }
+    int numRanks = params.getIntParam("sim-ranks");
+    if (numRanks < 1) {
+        log(V0_CRIT, "ERROR: Invalid number of simulated ranks %i\n", numRanks);
+        exit(1);
+    }
+
+    int seed = params.getIntParam("sim-seed");
+    Random::init(seed, seed);
+
+    auto jobs = BalancingSimulator::readScenario(scenario);
+    if (jobs.empty()) {
+        log(V0_CRIT, "ERROR: No jobs in scenario \"%s\"\n", scenario.c_str());
+        exit(1);
+    }
+
+    BalancingSimulator sim(params, numRanks, params.getFloatParam("sim-latency"),
+            params.getFloatParam("sim-work"));
+    float time = Timer::elapsedSeconds();
+    sim.run(jobs, params.getFloatParam("T"));
+    sim.logReport();
+    log(V2_INFO, "Simulated %.3fs in %.3fs\n", sim.getSimulatedTime(), Timer::elapsedSeconds() - time);
+
+    Logger::getMainInstance().flush();
+    return 0;
+}
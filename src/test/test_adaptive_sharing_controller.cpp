@@ -0,0 +1,92 @@
+
+#include <iostream>
+#include <assert.h>
+#include <vector>
+#include <algorithm>
+
+#include "util/random.hpp"
+#include "util/logger.hpp"
+#include "util/sys/timer.hpp"
+#include "app/sat/adaptive_sharing_controller.hpp"
+
+// Simulates sharing rounds of a root with numLeaves leaves which begin at random
+// times. A round is reduced and broadcast <reductionLatency> seconds after the
+// last leaf has contributed. Returns the sharing period after each round.
+std::vector<float> simulate(int numLeaves, float reductionLatency, float fillRatio, int numRounds) {
+
+    const float period = 1.0;
+    const float step = 0.001;
+    AdaptiveSharingController root(period, 1500, 4);
+    std::vector<AdaptiveSharingController> leaves(numLeaves, root);
+    std::vector<float> periods;
+
+    // Leaves start solving (and contribute for the first time) at different times
+    std::vector<float> firstGather(numLeaves);
+    for (auto& t : firstGather) t = Random::rand() * period;
+
+    float time = 0;
+    while ((int)periods.size() < numRounds) {
+        // Each leaf contributes once per round
+        float maxLatency = 0;
+        std::vector<bool> contributed(numLeaves, false);
+        int numContributed = 0;
+        while (numContributed < numLeaves) {
+            time += step;
+            for (int i = 0; i < numLeaves; i++) {
+                if (contributed[i]) continue;
+                bool due = periods.empty() ? time >= firstGather[i] : leaves[i].isTimeToGather(time);
+                if (!due) continue;
+                maxLatency = std::max(maxLatency, leaves[i].getLastLatency());
+                leaves[i].onGather(time);
+                contributed[i] = true;
+                numContributed++;
+            }
+        }
+        // Reduction, adaptation at the root, broadcast
+        time += reductionLatency;
+        root.adapt(fillRatio, 0, maxLatency);
+        for (auto& leaf : leaves) leaf.onBroadcast(time, root.getPeriod(), root.getBaseSize());
+        periods.push_back(root.getPeriod());
+    }
+    return periods;
+}
+
+void testNoDrift() {
+    // Moderately filled buffers and fast reduction: after the leaves' initial
+    // offsets have been measured, the period must not grow any further
+    for (int numLeaves : {2, 8, 32}) {
+        auto periods = simulate(numLeaves, 0.02, 0.5, 100);
+        log(V2_INFO, "%i leaves : period %.3f after 1 round, %.3f after %i rounds\n", numLeaves,
+                periods.front(), periods.back(), periods.size());
+        for (size_t r = 2; r < periods.size(); r++) assert(periods[r] <= periods[r-1]);
+        assert(periods.back() < 4);
+    }
+}
+
+void testSlowReduction() {
+    // A reduction which takes up most of a period does make the period grow
+    auto periods = simulate(8, 0.9, 0.5, 20);
+    assert(periods.back() > periods.front());
+}
+
+void testBounds() {
+    AdaptiveSharingController ctrl(1.0, 1000, 2);
+    for (int i = 0; i < 100; i++) ctrl.adapt(0.1, 0, 0);
+    assert(ctrl.getPeriod() == 2.0);
+    for (int i = 0; i < 100; i++) ctrl.adapt(1.0, 0, 0);
+    assert(ctrl.getPeriod() == 0.5);
+    assert(ctrl.getBaseSize() == 2000);
+    for (int i = 0; i < 100; i++) ctrl.adapt(0.5, 0.9, 0);
+    assert(ctrl.getBaseSize() == 500);
+}
+
+int main() {
+
+    Timer::init();
+    Random::init(rand(), rand());
+    Logger::init(0, V2_INFO, false, false, false, "/dev/null");
+
+    testNoDrift();
+    testSlowReduction();
+    testBounds();
+}
@@ -0,0 +1,105 @@
+
+#include <iostream>
+#include <assert.h>
+#include <vector>
+#include <string>
+#include <fstream>
+
+#include "util/random.hpp"
+#include "util/logger.hpp"
+#include "util/params.hpp"
+#include "util/sys/timer.hpp"
+#include "sim/balancing_simulator.hpp"
+
+void testReadScenario() {
+    std::string file = "/tmp/mallob_test_scenario";
+    {
+        std::ofstream out(file);
+        out << "# ID Arv Prio File\n";
+        out << "1 0.5 1 instances/a.cnf\n";
+        out << "\n";
+        out << "#2 1.0 1 instances/b.cnf\n";
+        out << "3 2.25 0.5 instances/c.cnf i\n";
+        out << "4 malformed\n";
+    }
+    auto jobs = BalancingSimulator::readScenario(file);
+    assert(jobs.size() == 2);
+    assert(jobs[0].id == 1 && jobs[0].arrival == 0.5f && jobs[0].priority == 1 && !jobs[0].incremental);
+    assert(jobs[1].id == 3 && jobs[1].arrival == 2.25f && jobs[1].priority == 0.5f && jobs[1].incremental);
+    assert(jobs[1].file == "instances/c.cnf");
+}
+
+std::vector<BalancingSimulator::ScenarioJob> getRandomScenario(int numJobs, float maxArrival) {
+    std::vector<BalancingSimulator::ScenarioJob> jobs;
+    for (int i = 1; i <= numJobs; i++) {
+        BalancingSimulator::ScenarioJob job;
+        job.id = i;
+        job.arrival = Random::rand() * maxArrival;
+        job.priority = 0.1 + 0.9 * Random::rand();
+        job.file = "";
+        jobs.push_back(job);
+    }
+    return jobs;
+}
+
+void testSimulation(Parameters& params, int numRanks, int numJobs) {
+
+    auto jobs = getRandomScenario(numJobs, 30);
+    float work = 20;
+    BalancingSimulator sim(params, numRanks, /*latency=*/0.0001, work);
+    sim.run(jobs, /*timeLimit=*/0);
+
+    log(V2_INFO, "N=%i n=%i g=%s r=%s : t=%.3f util=%.3f balancings=%i\n", numRanks, numJobs,
+            params.getParam("g").c_str(), params.getParam("r").c_str(), sim.getSimulatedTime(),
+            sim.getMeanUtilization(), sim.getNumBalancings());
+
+    // All jobs finished
+    auto stats = sim.getJobStats();
+    assert(stats.size() == jobs.size());
+    for (const auto& s : stats) {
+        assert(s.timeOfRootAdoption >= s.arrival);
+        assert(s.timeOfCompletion > s.timeOfRootAdoption || log_return_false("#%i unfinished\n", s.id));
+        assert(s.maxVolume >= 1 && s.maxVolume <= numRanks);
+        assert(s.numAdoptions >= 1);
+        // A job cannot finish faster than with all ranks
+        assert(s.timeOfCompletion - s.timeOfRootAdoption >= work / numRanks - 0.001);
+        // The volume integral accounts for exactly the job's work
+        assert(std::abs(s.volumeIntegral - work) < 0.01 || log_return_false("#%i : %.3f\n", s.id, s.volumeIntegral));
+    }
+    assert(sim.getMeanUtilization() > 0 && sim.getMeanUtilization() <= 1);
+    assert(sim.getNumBalancings() > 0);
+}
+
+int main(int argc, char** argv) {
+
+    Timer::init();
+    Random::init(rand(), rand());
+    Logger::init(0, V2_INFO, false, false, false, "/dev/null");
+
+    testReadScenario();
+
+    Parameters params;
+    params.init(argc, argv);
+    params["sim-sample-period"] = "1000";
+    for (std::string rounding : {ROUNDING_BISECTION, ROUNDING_PROBABILISTIC, ROUNDING_FLOOR}) {
+        params["r"] = rounding;
+        for (std::string growth : {"0", "1.0", "5.0"}) {
+            params["g"] = growth;
+            testSimulation(params, 1, 5);
+            testSimulation(params, 7, 20);
+            testSimulation(params, 64, 20);
+            testSimulation(params, 500, 100);
+        }
+    }
+
+    // Several job slots per rank, non-derandomized bouncing
+    params["r"] = ROUNDING_BISECTION;
+    params["g"] = "1.0";
+    for (std::string ajpw : {"2", "3"}) {
+        params["ajpw"] = ajpw;
+        testSimulation(params, 7, 20);
+        testSimulation(params, 64, 20);
+    }
+    params["derandomize"] = "0";
+    testSimulation(params, 64, 20);
+}
@@ -0,0 +1,110 @@
+
+#include <iostream>
+#include <assert.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "util/random.hpp"
+#include "util/logger.hpp"
+#include "util/sys/timer.hpp"
+#include "app/sat/hordesat/utilities/clause_buffer_codec.hpp"
+
+// Literals sorted like the codec does: by variable, positive before negative
+void sortLiterals(int* begin, int* end) {
+    std::sort(begin, end, [](int l, int r) {
+        return std::abs(l) < std::abs(r) || (std::abs(l) == std::abs(r) && l > r);
+    });
+}
+
+// Random buffer in the format of ClauseDatabase::giveSelection
+std::vector<int> getRandomBuffer(int numVars, int numVips, int maxLength, int maxClausesPerLength) {
+    std::vector<int> buffer;
+    auto randomLit = [&]() {
+        int var = 1 + (int) (Random::rand() * numVars);
+        return Random::rand() < 0.5 ? -var : var;
+    };
+    buffer.push_back(numVips);
+    for (int i = 0; i < numVips; i++) {
+        int size = 1 + (int) (Random::rand() * maxLength);
+        for (int j = 0; j < size; j++) buffer.push_back(randomLit());
+        buffer.push_back(0);
+    }
+    for (int length = 1; length <= maxLength; length++) {
+        int numCls = (int) (Random::rand() * maxClausesPerLength);
+        buffer.push_back(numCls);
+        for (int i = 0; i < numCls; i++) {
+            if (length > 1) buffer.push_back(2 + (int) (Random::rand() * (length-1)));
+            for (int j = 0; j < (length > 1 ? length-1 : 1); j++) buffer.push_back(randomLit());
+        }
+    }
+    return buffer;
+}
+
+// Expected result of decoding: the literals of each clause are sorted
+std::vector<int> normalize(std::vector<int> buffer) {
+    size_t pos = 0;
+    int numVips = buffer[pos++];
+    for (int i = 0; i < numVips; i++) {
+        size_t end = pos;
+        while (buffer[end] != 0) end++;
+        sortLiterals(buffer.data()+pos, buffer.data()+end);
+        pos = end+1;
+    }
+    int length = 1;
+    while (pos < buffer.size()) {
+        int numCls = buffer[pos++];
+        for (int i = 0; i < numCls; i++) {
+            if (length > 1) pos++;
+            int numLits = length > 1 ? length-1 : 1;
+            sortLiterals(buffer.data()+pos, buffer.data()+pos+numLits);
+            pos += numLits;
+        }
+        length++;
+    }
+    return buffer;
+}
+
+void testRoundtrip(const std::vector<int>& buffer) {
+    std::vector<int> encoded, decoded;
+    ClauseBufferCodec::encode(buffer, encoded);
+    ClauseBufferCodec::decode(encoded, decoded);
+    assert(decoded == normalize(buffer) || log_return_false("Roundtrip failed for buffer of size %i\n", buffer.size()));
+}
+
+int main() {
+
+    Timer::init();
+    Random::init(rand(), rand());
+    Logger::init(0, V2_INFO, false, false, false, "/dev/null");
+
+    // Empty buffers
+    std::vector<int> encoded, decoded;
+    ClauseBufferCodec::encode(std::vector<int>(), encoded);
+    ClauseBufferCodec::decode(encoded, decoded);
+    assert(decoded.empty());
+    testRoundtrip(std::vector<int>(1, 0));
+
+    // Extreme literals
+    testRoundtrip(std::vector<int>({0, 1, INT32_MAX, 0, 1, 2, -INT32_MAX, 1}));
+
+    for (int i = 0; i < 1000; i++) {
+        int numVars = 1 + (int) (Random::rand() * 1000000);
+        int numVips = Random::rand() < 0.1 ? (int) (Random::rand() * 5) : 0;
+        testRoundtrip(getRandomBuffer(numVars, numVips, 1 + (int) (Random::rand() * 30), 
+                (int) (Random::rand() * 100)));
+    }
+
+    // Compression and speed on a large buffer
+    auto buffer = getRandomBuffer(1000000, 0, 20, 5000);
+    float time = Timer::elapsedSeconds();
+    ClauseBufferCodec::encode(buffer, encoded);
+    float encodeTime = Timer::elapsedSeconds() - time;
+    time = Timer::elapsedSeconds();
+    ClauseBufferCodec::decode(encoded, decoded);
+    float decodeTime = Timer::elapsedSeconds() - time;
+    assert(decoded == normalize(buffer));
+    log(V2_INFO, "%i ints -> %i ints (%.3f), encode %.5fs, decode %.5fs\n", buffer.size(), encoded.size(), 
+            (float)encoded.size()/buffer.size(), encodeTime, decodeTime);
+    assert(encoded.size() < buffer.size());
+}
@@ -0,0 +1,106 @@
+
+#include <iostream>
+#include <assert.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <set>
+
+#include "util/random.hpp"
+#include "util/logger.hpp"
+#include "util/sys/timer.hpp"
+#include "util/robin_hood.hpp"
+#include "app/sat/hordesat/utilities/clause_filter.hpp"
+
+// (glue+1) followed by distinct random literals
+std::vector<int> getRandomClause(int numLits, int numVars) {
+    std::vector<int> cls(1, 3);
+    while ((int)cls.size() < numLits+1) {
+        int lit = (Random::rand() < 0.5 ? -1 : 1) * (1 + (int) (Random::rand() * numVars));
+        if (std::find(cls.begin()+1, cls.end(), lit) == cls.end()
+                && std::find(cls.begin()+1, cls.end(), -lit) == cls.end())
+            cls.push_back(lit);
+    }
+    return cls;
+}
+
+void testHashProperties() {
+    for (int i = 0; i < 1000; i++) {
+        auto cls = getRandomClause(2 + (int) (Random::rand() * 20), 1000);
+        size_t h = ClauseFilter::hash(cls, 1, /*skipFirst=*/true);
+
+        // Order of literals and glue are irrelevant
+        auto shuffled = cls;
+        for (size_t j = shuffled.size()-1; j > 1; j--) {
+            std::swap(shuffled[j], shuffled[1 + (int) (Random::rand() * j)]);
+        }
+        shuffled[0] = 7;
+        assert(ClauseFilter::hash(shuffled, 1, true) == h);
+
+        // Flipping a sign or dropping a literal changes the hash,
+        // and so does choosing another hash function
+        auto flipped = cls;
+        flipped[1] = -flipped[1];
+        assert(ClauseFilter::hash(flipped, 1, true) != h);
+        auto shortened = cls;
+        shortened.pop_back();
+        assert(ClauseFilter::hash(shortened, 1, true) != h);
+        assert(ClauseFilter::hash(cls, 2, true) != h);
+    }
+}
+
+void testCollisions(int numClauses) {
+    // Clauses over few variables, so that many of them are similar
+    std::vector<std::vector<int>> clauses;
+    for (int i = 0; i < numClauses; i++) {
+        clauses.push_back(getRandomClause(2 + (int) (Random::rand() * 4), 20));
+    }
+    robin_hood::unordered_set<size_t> hashes;
+    float time = Timer::elapsedSeconds();
+    for (const auto& cls : clauses) hashes.insert(ClauseFilter::hash(cls, 1, true));
+    time = Timer::elapsedSeconds() - time;
+
+    // Compare against the exact set of (sorted) clauses
+    std::set<std::vector<int>> exact;
+    for (auto cls : clauses) {
+        std::sort(cls.begin()+1, cls.end());
+        exact.insert(std::vector<int>(cls.begin()+1, cls.end()));
+    }
+    log(V2_INFO, "%i clauses : %i distinct, %i distinct hashes, %.4fs\n", numClauses, exact.size(),
+            hashes.size(), time);
+    assert(hashes.size() == exact.size());
+}
+
+void testFilter() {
+    ClauseFilter filter(/*maxClauseLen=*/5, /*checkUnits=*/true);
+    std::vector<int> cls = {3, 1, -2, 3};
+    assert(filter.registerClause(cls));
+    assert(!filter.registerClause(cls));
+    // Clauses which only differ in their last literal are distinct
+    std::vector<int> other = {3, 1, -2, 4};
+    assert(filter.registerClause(other));
+    // Length limit excludes the glue
+    std::vector<int> longCls = {3, 1, 2, 3, 4, 5};
+    assert(filter.registerClause(longCls));
+    longCls.push_back(6);
+    assert(!filter.registerClause(longCls));
+    // Units
+    std::vector<int> unit = {5};
+    assert(filter.registerClause(unit));
+    assert(!filter.registerClause(unit));
+    filter.age();
+    assert(!filter.registerClause(cls));
+    filter.age();
+    assert(filter.registerClause(cls));
+}
+
+int main() {
+
+    Timer::init();
+    Random::init(rand(), rand());
+    Logger::init(0, V2_INFO, false, false, false, "/dev/null");
+
+    testHashProperties();
+    testCollisions(100000);
+    testFilter();
+}
@@ -0,0 +1,112 @@
+
+#include <iostream>
+#include <assert.h>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+
+#include "util/random.hpp"
+#include "util/logger.hpp"
+#include "util/sys/timer.hpp"
+#include "app/sat/hordesat/utilities/concurrent_clause_filter.hpp"
+
+// (glue+1) followed by distinct literals, or a single literal
+std::vector<int> getClause(int id, int numLits) {
+    std::vector<int> cls;
+    if (numLits > 1) cls.push_back(3);
+    for (int j = 0; j < numLits; j++) cls.push_back((j % 2 == 0 ? -1 : 1) * (1 + id*numLits + j));
+    return cls;
+}
+
+void testOrigins() {
+    ConcurrentClauseFilter filter(/*maxClauseLen=*/10);
+    uint64_t all = 0b1111;
+
+    auto cls = getClause(1, 5);
+    assert(filter.registerProducedClause(cls.data(), cls.size(), 2));
+    // Duplicate export: by the same or by another solver
+    assert(!filter.registerProducedClause(cls.data(), cls.size(), 2));
+    assert(!filter.registerProducedClause(cls.data(), cls.size(), 0));
+    // Import: not delivered to its producers, afterwards known to everyone
+    assert(filter.registerImportedClause(cls.data(), cls.size(), all) == 0b1010);
+    assert(filter.registerImportedClause(cls.data(), cls.size(), all) == 0);
+
+    // Unknown clause is delivered to all solvers, literal order does not matter
+    auto other = getClause(2, 3);
+    assert(filter.registerImportedClause(other.data(), other.size(), all) == all);
+    std::swap(other[1], other[3]);
+    assert(!filter.registerProducedClause(other.data(), other.size(), 1));
+
+    // Units are compared exactly
+    int unit = 42, negUnit = -42;
+    assert(filter.registerProducedClause(&unit, 1, 3));
+    assert(filter.registerProducedClause(&negUnit, 1, 3));
+    assert(filter.registerImportedClause(&unit, 1, all) == 0b0111);
+
+    // Clauses above the length limit are blocked
+    auto longCls = getClause(3, 11);
+    assert(!filter.registerProducedClause(longCls.data(), longCls.size(), 0));
+
+    // Clauses survive one aging step, but not two
+    filter.age();
+    assert(!filter.registerProducedClause(cls.data(), cls.size(), 1));
+    filter.age();
+    assert(filter.registerProducedClause(cls.data(), cls.size(), 1));
+    filter.clear();
+    assert(filter.registerImportedClause(cls.data(), cls.size(), all) == all);
+}
+
+void testConcurrentExport(int numThreads, int numClauses) {
+    ConcurrentClauseFilter filter(/*maxClauseLen=*/0);
+    std::atomic_int numAdmitted(0);
+
+    // All threads export the same clauses: each clause is admitted (at most) once
+    float time = Timer::elapsedSeconds();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < numClauses; i++) {
+                auto cls = getClause(i, 2 + i % 10);
+                if (filter.registerProducedClause(cls.data(), cls.size(), t)) numAdmitted++;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    time = Timer::elapsedSeconds() - time;
+    log(V2_INFO, "%i threads x %i clauses : %i admitted, %.4fs\n", numThreads, numClauses,
+            numAdmitted.load(), time);
+
+    // Up to a load of 1/10, duplicates are detected exactly
+    assert(numClauses <= CCF_NUM_SLOTS / 10);
+    assert(numAdmitted == numClauses || log_return_false("%i admitted\n", numAdmitted.load()));
+}
+
+void testFullBuckets() {
+    ConcurrentClauseFilter filter(/*maxClauseLen=*/0);
+
+    // Overfill the filter: full buckets replace their oldest clauses
+    int numClauses = 2 * CCF_NUM_SLOTS;
+    for (int i = 0; i < numClauses; i++) {
+        auto cls = getClause(i, 2 + i % 10);
+        filter.registerProducedClause(cls.data(), cls.size(), 0);
+    }
+    // The most recent clauses are all remembered
+    for (int i = numClauses - CCF_NUM_SLOTS / 100; i < numClauses; i++) {
+        auto cls = getClause(i, 2 + i % 10);
+        assert(!filter.registerProducedClause(cls.data(), cls.size(), 1) || log_return_false("clause %i forgotten\n", i));
+    }
+}
+
+int main() {
+
+    Timer::init();
+    Random::init(rand(), rand());
+    Logger::init(0, V2_INFO, false, false, false, "/dev/null");
+
+    testOrigins();
+    testConcurrentExport(1, CCF_NUM_SLOTS / 10);
+    testConcurrentExport(4, CCF_NUM_SLOTS / 10);
+    testConcurrentExport(16, CCF_NUM_SLOTS / 10);
+    testFullBuckets();
+}
@@ -0,0 +1,124 @@
+
+#include <iostream>
+#include <assert.h>
+#include <vector>
+#include <string>
+#include <set>
+
+#include "util/random.hpp"
+#include "util/logger.hpp"
+#include "util/sys/timer.hpp"
+#include "app/sat/hordesat/utilities/clause_database.hpp"
+#include "app/sat/hordesat/utilities/lbd_clause_selector.hpp"
+
+struct Clause {
+    std::vector<int> data; // (glue+1) followed by literals, or a single literal
+    int lbd() const {return data.size() == 1 ? 1 : data[0]-1;}
+    int size() const {return data.size();}
+};
+
+std::vector<Clause> getRandomClauses(int numClauses, int maxSize) {
+    std::vector<Clause> clauses;
+    for (int i = 0; i < numClauses; i++) {
+        Clause c;
+        int numLits = 1 + (int) (Random::rand() * (maxSize-1));
+        if (numLits > 1) c.data.push_back(1 + 1 + (int) (Random::rand() * numLits));
+        for (int j = 0; j < numLits; j++) {
+            // Distinct literals to make every clause unique
+            c.data.push_back((Random::rand() < 0.5 ? -1 : 1) * (1 + i*maxSize + j));
+        }
+        clauses.push_back(c);
+    }
+    return clauses;
+}
+
+// Parses the length buckets of a buffer (without VIP clauses) into a set of clauses
+std::set<std::vector<int>> parse(const std::vector<int>& buffer, size_t pos) {
+    std::set<std::vector<int>> clauses;
+    int length = 1;
+    while (pos < buffer.size()) {
+        int numCls = buffer[pos++];
+        assert(numCls >= 0);
+        for (int i = 0; i < numCls; i++) {
+            assert(pos + length <= buffer.size());
+            std::vector<int> cls(buffer.begin()+pos, buffer.begin()+pos+length);
+            for (size_t j = (length > 1 ? 1 : 0); j < cls.size(); j++) assert(cls[j] != 0);
+            clauses.insert(cls);
+            pos += length;
+        }
+        length++;
+    }
+    assert(pos == buffer.size());
+    return clauses;
+}
+
+void checkSelection(const std::vector<Clause>& clauses, const std::set<std::vector<int>>& selected) {
+    // No clause was left out in favor of a clause with higher LBD of the same or a larger size:
+    // the budget only shrinks during the greedy selection
+    int minUnselectedLbdPerSize[64];
+    for (int s = 0; s < 64; s++) minUnselectedLbdPerSize[s] = INT32_MAX;
+    for (const auto& c : clauses) if (!selected.count(c.data)) 
+        minUnselectedLbdPerSize[c.size()] = std::min(minUnselectedLbdPerSize[c.size()], c.lbd());
+    for (const auto& c : clauses) if (selected.count(c.data)) {
+        for (int s = 1; s <= c.size(); s++) {
+            assert(minUnselectedLbdPerSize[s] >= c.lbd() 
+                || log_return_false("Selected size=%i lbd=%i, but not size=%i lbd=%i\n", 
+                c.size(), c.lbd(), s, minUnselectedLbdPerSize[s]));
+        }
+    }
+}
+
+void testSelector(int numClauses, int maxSize, size_t maxBufferSize) {
+    auto clauses = getRandomClauses(numClauses, maxSize);
+    LbdClauseSelector selector;
+    for (const auto& c : clauses) selector.add(c.data.data(), c.size());
+
+    std::vector<int> buffer(1, 0); // no VIP clauses
+    int numSelected = selector.writeSelection(buffer, maxBufferSize);
+    assert(buffer.size() <= maxBufferSize);
+    auto selected = parse(buffer, 1);
+    assert((int)selected.size() == numSelected);
+    for (const auto& cls : selected) {
+        bool found = false;
+        for (const auto& c : clauses) found = found || c.data == cls;
+        assert(found);
+    }
+    checkSelection(clauses, selected);
+    if (numSelected > 0) assert(buffer.back() != 0);
+}
+
+void testClauseDatabase(int numClauses, int maxSize, unsigned int maxBufferSize) {
+    auto allClauses = getRandomClauses(numClauses, maxSize);
+    ClauseDatabase cdb(Logger::getMainInstance(), /*numProducers=*/1, /*maxClauseSize=*/maxSize+1, /*selectByLbd=*/true);
+    // Clauses are dropped if the bucket of their size is full
+    std::vector<Clause> clauses;
+    for (const auto& c : allClauses) if (cdb.addClause(0, c.data)) clauses.push_back(c);
+
+    std::vector<int> buffer(maxBufferSize);
+    int numSelected;
+    unsigned int used = cdb.giveSelection(buffer.data(), maxBufferSize, &numSelected);
+    assert(used <= maxBufferSize);
+    buffer.resize(used);
+    assert(buffer[0] == 0);
+    auto selected = parse(buffer, 1);
+    assert((int)selected.size() == numSelected);
+    checkSelection(clauses, selected);
+}
+
+int main() {
+
+    Timer::init();
+    Random::init(rand(), rand());
+    Logger::init(0, V2_INFO, false, false, false, "/dev/null");
+
+    for (int i = 0; i < 200; i++) {
+        int numClauses = (int) (Random::rand() * 300);
+        int maxSize = 2 + (int) (Random::rand() * 20);
+        size_t maxBufferSize = 1 + (int) (Random::rand() * 1500);
+        testSelector(numClauses, maxSize, maxBufferSize);
+        testClauseDatabase(numClauses, maxSize, maxBufferSize);
+    }
+    // Everything fits
+    testSelector(100, 10, 100000);
+    testClauseDatabase(100, 10, 100000);
+}
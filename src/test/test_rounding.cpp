@@ -0,0 +1,123 @@
+
+#include <iostream>
+#include <assert.h>
+#include <vector>
+#include <string>
+
+#include "util/random.hpp"
+#include "util/logger.hpp"
+#include "util/sys/timer.hpp"
+#include "balancing/rounding.hpp"
+
+// Reference: bisection which rounds all assignments in each iteration (former implementation)
+Rounding::BisectionResult bisectNaively(const robin_hood::unordered_map<int, double>& assignments,
+        int numNodes, float loadFactor, SortedDoubleSequence& remainders) {
+
+    for (const auto& [jobId, assignment] : assignments) {
+        double remainder = assignment - (int)assignment;
+        if (remainder > 0 && remainder < 1) remainders.add(remainder);
+    }
+    int lower = 0, upper = remainders.size();
+    int idx = (lower+upper)/2;
+    int iterations = 0;
+    float lastUtilization = -1;
+
+    Rounding::BisectionResult best;
+    best.remainderIdx = -1;
+
+    while (true) {
+        int utilization = 0;
+        if (idx <= remainders.size()) {
+            Rounding::getRoundedAssignments(idx, utilization, remainders, assignments);
+        }
+        float p = Rounding::penalty((float)utilization / numNodes, loadFactor);
+        if (best.remainderIdx == -1 || p < best.penalty) {
+            best.penalty = p;
+            best.remainderIdx = idx;
+            best.utilization = utilization;
+        }
+        if (utilization == lastUtilization) break;
+        else if (lower < upper) {
+            if (utilization < loadFactor*numNodes) upper = idx-1;
+            if (utilization > loadFactor*numNodes) lower = idx+1;
+            idx = (lower+upper)/2;
+        }
+        lastUtilization = utilization;
+        iterations++;
+    }
+    best.iterations = iterations;
+    return best;
+}
+
+robin_hood::unordered_map<int, double> getRandomAssignments(int numJobs, int numNodes) {
+    robin_hood::unordered_map<int, double> assignments;
+    double maxAssignment = std::max(1.0, 2.0 * numNodes / numJobs);
+    for (int jobId = 0; jobId < numJobs; jobId++) {
+        double r = Random::rand();
+        if (r < 0.1) {
+            // integer assignment
+            assignments[jobId] = (int) (Random::rand() * maxAssignment);
+        } else if (r < 0.2 && jobId > 0) {
+            // duplicate remainder
+            assignments[jobId] = assignments[jobId-1];
+        } else {
+            assignments[jobId] = Random::rand() * maxAssignment;
+        }
+    }
+    return assignments;
+}
+
+void testRounding(int numJobs, int numNodes, float loadFactor) {
+
+    auto assignments = getRandomAssignments(numJobs, numNodes);
+
+    SortedDoubleSequence naiveRemainders;
+    float time = Timer::elapsedSeconds();
+    auto naive = bisectNaively(assignments, numNodes, loadFactor, naiveRemainders);
+    float naiveTime = Timer::elapsedSeconds() - time;
+
+    SortedDoubleSequence remainders;
+    std::vector<int> utilizations;
+    time = Timer::elapsedSeconds();
+    Rounding::getUtilizationsPerRemainder(assignments, remainders, utilizations);
+    auto result = Rounding::bisect(remainders, utilizations, numNodes, loadFactor, 0, V5_DEBG);
+    float fastTime = Timer::elapsedSeconds() - time;
+
+    log(V2_INFO, "n=%i N=%i l=%.2f : naive %.5fs, fast %.5fs\n", numJobs, numNodes, loadFactor, naiveTime, fastTime);
+
+    assert(remainders.data == naiveRemainders.data);
+    if (numJobs <= 1000) {
+        for (int idx = 0; idx <= remainders.size(); idx++) {
+            int utilization = 0;
+            Rounding::getRoundedAssignments(idx, utilization, remainders, assignments);
+            assert(utilization == utilizations[idx]
+                || log_return_false("idx=%i : utilization %i != %i\n", idx, utilization, utilizations[idx]));
+        }
+    }
+    assert(result.remainderIdx == naive.remainderIdx);
+    assert(result.iterations == naive.iterations);
+    assert(result.utilization == naive.utilization);
+    assert(result.penalty == naive.penalty);
+
+    int sum = 0, naiveSum = 0;
+    auto volumes = Rounding::getRoundedAssignments(result.remainderIdx, sum, remainders, assignments);
+    auto naiveVolumes = Rounding::getRoundedAssignments(naive.remainderIdx, naiveSum, naiveRemainders, assignments);
+    assert(sum == naiveSum);
+    assert(volumes == naiveVolumes);
+}
+
+int main() {
+
+    Timer::init();
+    Random::init(rand(), rand());
+    Logger::init(0, V5_DEBG, false, false, false, "/dev/null");
+
+    for (int i = 0; i < 1000; i++) {
+        int numJobs = 1 + (int) (Random::rand() * 200);
+        int numNodes = 1 + (int) (Random::rand() * 400);
+        float loadFactor = 0.5 + 0.49 * Random::rand();
+        testRounding(numJobs, numNodes, loadFactor);
+    }
+    testRounding(5000, 10000, 0.95);
+    testRounding(20000, 50000, 0.95);
+}
@@ -1,13 +1,114 @@
 
 #include <iostream>
+#include <fstream>
 #include <assert.h>
 #include <vector>
 #include <string>
 
 #include "util/random.hpp"
 #include "util/sat_reader.hpp"
+#include "util/formula_cache.hpp"
 #include "util/logger.hpp"
 #include "util/sys/timer.hpp"
+#include "util/sys/proc.hpp"
+
+std::vector<uint8_t> readWithThreads(const std::string& file, int numThreads, int& numVars) {
+    SatReader r(file, numThreads);
+    JobDescription d(1, 1.0, false);
+    bool success = r.read(d);
+    assert(success);
+    numVars = d.getNumVars();
+    return *d.getSerialization();
+}
+
+void testParallelReading(const std::string& file) {
+    log(V2_INFO, "Comparing sequential and parallel reading of %s ...\n", file.c_str());
+    int numVarsSeq;
+    auto seq = readWithThreads(file, 1, numVarsSeq);
+    for (int numThreads : {2, 3, 4, 7, 16}) {
+        int numVarsPar;
+        float time = Timer::elapsedSeconds();
+        auto par = readWithThreads(file, numThreads, numVarsPar);
+        time = Timer::elapsedSeconds() - time;
+        log(V2_INFO, " - %i threads: %.3fs\n", numThreads, time);
+        assert(numVarsSeq == numVarsPar);
+        assert(seq == par || log_return_false("Parallel reading with %i threads differs!\n", numThreads));
+    }
+}
+
+void testCompressedReading(const std::string& file) {
+    int numVarsPlain;
+    auto plain = readWithThreads(file, 1, numVarsPlain);
+    for (std::string compressor : {"xz", "lzma", "gzip"}) {
+        std::string ext = compressor == "gzip" ? ".gz" : "." + compressor;
+        auto cmd = compressor + " -c " + file + " > " + file + ext;
+        int retval = system(cmd.c_str());
+        assert(retval == 0);
+        log(V2_INFO, "Reading %s compressed with %s ...\n", file.c_str(), compressor.c_str());
+        int numVars;
+        auto decompressed = readWithThreads(file + ext, 1, numVars);
+        assert(numVars == numVarsPlain);
+        assert(decompressed == plain || log_return_false("Reading %s compressed with %s differs!\n", 
+            file.c_str(), compressor.c_str()));
+    }
+}
+
+void testFormulaCache(const std::string& file) {
+    log(V2_INFO, "Caching %s ...\n", file.c_str());
+    FormulaCache cache("/tmp/mallob_test_formula_cache." + std::to_string(Proc::getPid()));
+    assert(cache.isEnabled());
+
+    uint64_t key;
+    bool success = cache.getKey(file, key);
+    assert(success);
+    JobDescription d(1, 1.0, false);
+    assert(!cache.load(key, d));
+
+    int numVars;
+    auto parsed = readWithThreads(file, 1, numVars);
+    SatReader r(file);
+    r.read(d);
+    success = cache.store(key, d);
+    assert(success);
+
+    // Same content at a different path yields the same key
+    auto copy = file + ".copy";
+    int retval = system(("cp " + file + " " + copy).c_str());
+    assert(retval == 0);
+    uint64_t copyKey;
+    success = cache.getKey(copy, copyKey);
+    assert(success);
+    assert(key == copyKey);
+
+    JobDescription cached(1, 1.0, false);
+    success = cache.load(copyKey, cached);
+    assert(success);
+    assert(cached.getNumVars() == numVars);
+    assert(*cached.getSerialization() == parsed);
+
+    // Changed content yields a different key
+    std::ofstream(copy, std::ios::app) << "1 2 0\n";
+    success = cache.getKey(copy, copyKey);
+    assert(success);
+    assert(key != copyKey);
+    assert(!cache.load(copyKey, cached));
+}
+
+void writeRandomCnf(const std::string& file, int numClauses, bool trailingNewline, bool malformed) {
+    std::ofstream out(file);
+    out << "c random test formula\np cnf 1000 " << numClauses << "\n";
+    for (int i = 0; i < numClauses; i++) {
+        if (Random::rand() < 0.05) out << "c some comment - with 1 2 3 numbers\n";
+        int len = 1 + (int) (Random::rand() * 10);
+        for (int j = 0; j < len; j++) {
+            int lit = 1 + (int) (Random::rand() * 1000);
+            out << (Random::rand() < 0.5 ? -lit : lit) << (Random::rand() < 0.1 ? "  " : " ");
+        }
+        // A dangling minus sign carries over to the next line
+        if (malformed && Random::rand() < 0.01) out << "-\n";
+        else out << "0" << (i+1 < numClauses || trailingNewline ? "\n" : "");
+    }
+}
 
 int main() {
 
@@ -15,8 +116,21 @@ int main() {
     Random::init(rand(), rand());
     Logger::init(0, V5_DEBG, false, false, false, "/dev/null");
 
-    auto files = {"Steiner-9-5-bce.cnf.xz", "uum12.smt2.cnf.xz", 
-        "LED_round_29-32_faultAt_29_fault_injections_5_seed_1579630418.cnf.xz", "SAT_dat.k80.cnf.xz", "Timetable_C_497_E_62_Cl_33_S_30.cnf.xz", 
+    // Generated formulae
+    std::string genFile = "/tmp/mallob_test_sat_reader.cnf";
+    writeRandomCnf(genFile, 100000, /*trailingNewline=*/true, /*malformed=*/false);
+    testParallelReading(genFile);
+    writeRandomCnf(genFile, 100000, /*trailingNewline=*/false, /*malformed=*/false);
+    testParallelReading(genFile);
+    testCompressedReading(genFile);
+    testFormulaCache(genFile);
+    writeRandomCnf(genFile, 100000, /*trailingNewline=*/true, /*malformed=*/true);
+    testParallelReading(genFile);
+    writeRandomCnf(genFile, 3, /*trailingNewline=*/false, /*malformed=*/false);
+    testParallelReading(genFile);
+
+    auto files = {"Steiner-9-5-bce.cnf.xz", "uum12.smt2.cnf.xz",
+        "LED_round_29-32_faultAt_29_fault_injections_5_seed_1579630418.cnf.xz", "SAT_dat.k80.cnf.xz", "Timetable_C_497_E_62_Cl_33_S_30.cnf.xz",
         "course0.2_2018_3-sc2018.cnf.xz", "sv-comp19_prop-reachsafety.queue_longer_false-unreach-call.i-witness.cnf.xz"};
 
     for (const auto& file : files) {
@@ -40,5 +154,7 @@ int main() {
         assert(retval == 0);
 
         log(V2_INFO, " -- difference: %.3fs\n", time - time2);
+
+        testParallelReading("/tmp/tmpfile");
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,226 @@
+
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#include "async_log_writer.hpp"
+#include "util/sys/timer.hpp"
+
+#define RING_MASK (LOG_BUFFER_SIZE_PER_THREAD-1)
+#define RECORD_ALIGNMENT 8
+
+thread_local AsyncLogWriter::ThreadRing AsyncLogWriter::_thread_ring;
+
+AsyncLogWriter::~AsyncLogWriter() {
+    stop();
+}
+
+void AsyncLogWriter::start(int rank, FILE* reportFile, bool reportToStdout) {
+    if (_running) return;
+    _rank = rank;
+    _report_file = reportFile;
+    _report_to_stdout = reportToStdout;
+    _running = true;
+    _thread = std::thread([this]() {run();});
+}
+
+void AsyncLogWriter::stop() {
+    if (!_running) return;
+    _running = false;
+    {
+        std::unique_lock<std::mutex> lock(_sleep_mutex);
+        _sleep_cond.notify_all();
+    }
+    if (_thread.joinable()) _thread.join();
+    // Write all remaining lines
+    consumeAndWrite();
+}
+
+bool AsyncLogWriter::enqueue(FILE* file, bool toStdout, int color, const char* text, size_t textLength) {
+
+    Ring& ring = getThreadRing();
+    size_t size = (sizeof(RecordHeader) + textLength + RECORD_ALIGNMENT-1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+    if (size > LOG_BUFFER_SIZE_PER_THREAD/2) {
+        _num_dropped++;
+        return false;
+    }
+
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    uint64_t tail = ring.tail.load(std::memory_order_acquire);
+    size_t pos = head & RING_MASK;
+    size_t contiguous = LOG_BUFFER_SIZE_PER_THREAD - pos;
+    // A record never wraps around: skip the end of the buffer if necessary
+    size_t padding = (size > contiguous) ? contiguous : 0;
+    if (LOG_BUFFER_SIZE_PER_THREAD - (head - tail) < padding + size) {
+        _num_dropped++;
+        return false;
+    }
+
+    RecordHeader header;
+    if (padding > 0) {
+        // (too small remainders are skipped implicitly)
+        if (padding >= sizeof(RecordHeader)) {
+            header.size = padding;
+            header.padding = true;
+            memcpy(ring.data.get()+pos, &header, sizeof(RecordHeader));
+        }
+        head += padding;
+        pos = 0;
+    }
+    header.sequence = _sequence.fetch_add(1, std::memory_order_relaxed);
+    header.file = file;
+    header.size = size;
+    header.textLength = textLength;
+    header.color = color;
+    header.toStdout = toStdout;
+    header.padding = false;
+    memcpy(ring.data.get()+pos, &header, sizeof(RecordHeader));
+    memcpy(ring.data.get()+pos+sizeof(RecordHeader), text, textLength);
+    ring.head.store(head + size, std::memory_order_release);
+    return true;
+}
+
+void AsyncLogWriter::flush() {
+    consumeAndWrite();
+}
+
+void AsyncLogWriter::close(FILE* file) {
+    // No other party may hold records for the file while it is closed
+    std::unique_lock<std::timed_mutex> consumeLock(_consume_mutex);
+    writeRecords();
+    fclose(file);
+}
+
+AsyncLogWriter::Ring& AsyncLogWriter::getThreadRing() {
+    if (!_thread_ring.ring) {
+        _thread_ring.ring.reset(new Ring());
+        std::unique_lock<std::mutex> lock(_rings_mutex);
+        _rings.push_back(_thread_ring.ring);
+    }
+    return *_thread_ring.ring;
+}
+
+void AsyncLogWriter::run() {
+    while (_running) {
+        {
+            std::unique_lock<std::mutex> lock(_sleep_mutex);
+            _sleep_cond.wait_for(lock, std::chrono::milliseconds(LOG_FLUSH_PERIOD_MILLIS),
+                [&]() {return !_running;});
+        }
+        consumeAndWrite();
+    }
+}
+
+void AsyncLogWriter::consumeAndWrite() {
+
+    // Do not wait indefinitely, e.g., if the watchdog flushes the logs of a stuck process
+    std::unique_lock<std::timed_mutex> consumeLock(_consume_mutex, std::defer_lock);
+    if (!consumeLock.try_lock_for(std::chrono::seconds(1))) return;
+    writeRecords();
+}
+
+void AsyncLogWriter::writeRecords() {
+
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        std::unique_lock<std::mutex> lock(_rings_mutex);
+        rings = _rings;
+    }
+
+    // Collect all available records
+    struct Line {
+        uint64_t sequence;
+        FILE* file;
+        size_t textOffset;
+        size_t textLength;
+        int color;
+        bool toStdout;
+    };
+    std::vector<Line> lines;
+    std::string texts;
+    bool anyOrphanedEmpty = false;
+    for (auto& ring : rings) {
+        bool orphaned = ring->orphaned;
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        while (tail < head) {
+            size_t contiguous = LOG_BUFFER_SIZE_PER_THREAD - (tail & RING_MASK);
+            if (contiguous < sizeof(RecordHeader)) {
+                tail += contiguous;
+                continue;
+            }
+            const uint8_t* rec = ring->data.get() + (tail & RING_MASK);
+            RecordHeader header;
+            memcpy(&header, rec, sizeof(RecordHeader));
+            if (!header.padding) {
+                lines.push_back(Line{header.sequence, header.file, texts.size(),
+                    header.textLength, header.color, header.toStdout});
+                texts.append((const char*) rec + sizeof(RecordHeader), header.textLength);
+            }
+            tail += header.size;
+        }
+        ring->tail.store(tail, std::memory_order_release);
+        if (orphaned) anyOrphanedEmpty = true;
+    }
+
+    // Restore the global order of the lines
+    std::sort(lines.begin(), lines.end(), [](const Line& l, const Line& r) {
+        return l.sequence < r.sequence;
+    });
+
+    // Assemble output per destination
+    std::string stdoutOutput;
+    std::vector<std::pair<FILE*, std::string>> fileOutputs;
+    for (const auto& line : lines) {
+        const char* text = texts.data() + line.textOffset;
+        if (line.toStdout) {
+            if (line.color != 0) stdoutOutput += "\033[" + std::to_string(line.color) + "m";
+            stdoutOutput.append(text, line.textLength);
+            if (line.color != 0) stdoutOutput += "\033[39m";
+        }
+        if (line.file != nullptr) {
+            auto it = std::find_if(fileOutputs.begin(), fileOutputs.end(),
+                [&](const auto& pair) {return pair.first == line.file;});
+            if (it == fileOutputs.end()) {
+                fileOutputs.emplace_back(line.file, std::string());
+                it = fileOutputs.end()-1;
+            }
+            it->second.append(text, line.textLength);
+        }
+    }
+
+    // Report dropped lines
+    uint64_t numDropped = _num_dropped.load(std::memory_order_relaxed);
+    if (numDropped > _num_reported_dropped) {
+        char report[256];
+        int len = snprintf(report, sizeof(report), "%.3f %i [WARN] Dropped %lu log lines due to full log buffers\n",
+            Timer::elapsedSeconds(), _rank, (unsigned long) (numDropped - _num_reported_dropped));
+        if (_report_to_stdout) stdoutOutput.append(report, len);
+        if (_report_file != nullptr) {
+            auto it = std::find_if(fileOutputs.begin(), fileOutputs.end(),
+                [&](const auto& pair) {return pair.first == _report_file;});
+            if (it == fileOutputs.end()) fileOutputs.emplace_back(_report_file, std::string(report, len));
+            else it->second.append(report, len);
+        }
+        _num_reported_dropped = numDropped;
+    }
+
+    // Write each destination's output in one go
+    if (!stdoutOutput.empty()) {
+        fwrite(stdoutOutput.data(), 1, stdoutOutput.size(), stdout);
+        fflush(stdout);
+    }
+    for (auto& [file, output] : fileOutputs) {
+        fwrite(output.data(), 1, output.size(), file);
+        fflush(file);
+    }
+
+    // Discard the buffers of exited threads
+    if (anyOrphanedEmpty) {
+        std::unique_lock<std::mutex> lock(_rings_mutex);
+        _rings.erase(std::remove_if(_rings.begin(), _rings.end(), [](const auto& ring) {
+            return ring->orphaned && ring->tail.load() == ring->head.load();
+        }), _rings.end());
+    }
+}
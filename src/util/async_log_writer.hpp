@@ -0,0 +1,97 @@
+
+#ifndef DOMPASCH_MALLOB_ASYNC_LOG_WRITER_HPP
+#define DOMPASCH_MALLOB_ASYNC_LOG_WRITER_HPP
+
+#include <stdio.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Capacity (bytes, power of two) of the log buffer of each logging thread
+#define LOG_BUFFER_SIZE_PER_THREAD (1 << 18)
+// Period (milliseconds) in which the writer thread flushes buffered log lines
+#define LOG_FLUSH_PERIOD_MILLIS 5
+
+/*
+Backend for asynchronous logging. Each logging thread appends its readily
+formatted lines, as binary records, to its own lock-free single-producer
+single-consumer ring buffer. A dedicated writer thread periodically collects
+the records of all buffers, restores their global order, and writes them to
+their destinations in large batches. If a thread's buffer is full, its lines
+are dropped and counted; the writer reports the number of dropped lines.
+*/
+class AsyncLogWriter {
+
+private:
+    struct RecordHeader {
+        uint64_t sequence;
+        FILE* file;
+        uint32_t size; // total size of the record, including this header and padding
+        uint32_t textLength;
+        int color; // terminal color code for stdout output (0: none)
+        bool toStdout;
+        bool padding; // skip record: end of buffer reached
+    };
+
+    struct Ring {
+        std::unique_ptr<uint8_t[]> data;
+        alignas(64) std::atomic<uint64_t> head {0}; // written by producer
+        alignas(64) std::atomic<uint64_t> tail {0}; // written by consumer
+        std::atomic_bool orphaned {false}; // producing thread exited
+        Ring() : data(new uint8_t[LOG_BUFFER_SIZE_PER_THREAD]) {}
+    };
+
+    struct ThreadRing {
+        std::shared_ptr<Ring> ring;
+        ~ThreadRing() {if (ring) ring->orphaned = true;}
+    };
+    static thread_local ThreadRing _thread_ring;
+
+    std::vector<std::shared_ptr<Ring>> _rings;
+    std::mutex _rings_mutex;
+
+    std::atomic<uint64_t> _sequence {0};
+    std::atomic<uint64_t> _num_dropped {0};
+    uint64_t _num_reported_dropped = 0;
+    FILE* _report_file = nullptr;
+    bool _report_to_stdout = true;
+    int _rank = 0;
+
+    std::thread _thread;
+    std::atomic_bool _running {false};
+    std::mutex _sleep_mutex;
+    std::condition_variable _sleep_cond;
+
+    // Only one party at a time may consume and write records
+    std::timed_mutex _consume_mutex;
+
+public:
+    ~AsyncLogWriter();
+
+    // Launches the writer thread. Dropped lines are reported to reportFile (and to stdout).
+    void start(int rank, FILE* reportFile, bool reportToStdout);
+    // Writes all buffered lines and stops the writer thread.
+    void stop();
+    bool isRunning() const {return _running;}
+
+    // Lock-free (except for the first call of each thread).
+    // Returns false if the line was dropped.
+    bool enqueue(FILE* file, bool toStdout, int color, const char* text, size_t textLength);
+    // Writes all lines enqueued before this call. Gives up after one second
+    // if another party is writing and does not finish.
+    void flush();
+    // Blocks until all lines enqueued before this call have been written,
+    // then closes the file. No line may be enqueued for the file afterwards.
+    void close(FILE* file);
+
+private:
+    Ring& getThreadRing();
+    void run();
+    void consumeAndWrite();
+    void writeRecords();
+};
+
+#endif
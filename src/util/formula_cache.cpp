@@ -0,0 +1,160 @@
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <thread>
+#include <functional>
+
+#include "formula_cache.hpp"
+#include "util/sys/fileutils.hpp"
+#include "util/sys/proc.hpp"
+
+#define FORMULA_CACHE_MAGIC 0x6d616c6c6f62666dULL // "mallobfm"
+#define FORMULA_CACHE_VERSION 1
+
+FormulaCache::FormulaCache(const std::string& directory) : _directory(directory) {
+    if (isEnabled()) FileUtils::mkdir(_directory);
+}
+
+bool FormulaCache::getKey(const std::string& file, uint64_t& key) {
+
+    int fd = open(file.c_str(), O_RDONLY);
+    if (fd == -1) return false;
+    struct stat s;
+    if (fstat(fd, &s) == -1) {
+        close(fd);
+        return false;
+    }
+    FileStamp stamp {s.st_dev, s.st_ino, s.st_size,
+        (int64_t)s.st_mtim.tv_sec * 1000000000 + s.st_mtim.tv_nsec};
+
+    // Was this exact file hashed before?
+    {
+        auto lock = _keys_mutex.getLock();
+        auto it = _keys_by_path.find(file);
+        if (it != _keys_by_path.end() && it->second.first == stamp) {
+            key = it->second.second;
+            close(fd);
+            return true;
+        }
+    }
+
+    // Hash the file's content
+    if (s.st_size == 0) {
+        key = hashContent(nullptr, 0);
+    } else {
+        void* data = mmap(0, s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+        madvise(data, s.st_size, MADV_SEQUENTIAL);
+        key = hashContent((const uint8_t*) data, s.st_size);
+        munmap(data, s.st_size);
+    }
+    close(fd);
+
+    auto lock = _keys_mutex.getLock();
+    _keys_by_path[file] = std::pair<FileStamp, uint64_t>(stamp, key);
+    return true;
+}
+
+bool FormulaCache::load(uint64_t key, JobDescription& desc) {
+
+    int fd = open(getEntryPath(key).c_str(), O_RDONLY);
+    if (fd == -1) return false;
+    struct stat s;
+    if (fstat(fd, &s) == -1 || (size_t)s.st_size < sizeof(FormulaCacheHeader)) {
+        close(fd);
+        return false;
+    }
+    void* data = mmap(0, s.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+
+    // Validate header
+    FormulaCacheHeader header;
+    memcpy(&header, data, sizeof(FormulaCacheHeader));
+    bool valid = header.magic == FORMULA_CACHE_MAGIC && header.version == FORMULA_CACHE_VERSION
+        && header.key == key && (size_t)s.st_size == sizeof(FormulaCacheHeader) + header.numLits*sizeof(int);
+
+    if (valid) {
+        // Copy the mapped literals into the description in one go
+        madvise(data, s.st_size, MADV_SEQUENTIAL);
+        desc.beginInitialization();
+        desc.reserveSize(header.numLits * sizeof(int));
+        desc.addLiterals((const int*) ((const uint8_t*)data + sizeof(FormulaCacheHeader)), header.numLits);
+        desc.setNumVars(header.numVars);
+        desc.endInitialization();
+    }
+    munmap(data, s.st_size);
+    return valid;
+}
+
+bool FormulaCache::store(uint64_t key, const JobDescription& desc) {
+
+    FormulaCacheHeader header;
+    header.magic = FORMULA_CACHE_MAGIC;
+    header.key = key;
+    header.numLits = desc.getFormulaSize();
+    header.numVars = desc.getNumVars();
+    header.version = FORMULA_CACHE_VERSION;
+
+    // Write to a temporary file first, then atomically move it into place
+    // such that concurrent readers never see a partial entry
+    std::string path = getEntryPath(key);
+    std::string tmpPath = path + ".tmp." + std::to_string(Proc::getPid()) + "."
+        + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    FILE* f = fopen(tmpPath.c_str(), "wb");
+    if (f == nullptr) return false;
+    bool success = fwrite(&header, sizeof(FormulaCacheHeader), 1, f) == 1;
+    if (success && header.numLits > 0) {
+        success = fwrite(desc.getFormulaPayload(), sizeof(int), header.numLits, f) == header.numLits;
+    }
+    success = (fclose(f) == 0) && success;
+    if (success) success = rename(tmpPath.c_str(), path.c_str()) == 0;
+    if (!success) FileUtils::rm(tmpPath);
+    return success;
+}
+
+uint64_t FormulaCache::hashContent(const uint8_t* data, size_t size) {
+
+    const uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+    const uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+    auto rotl = [](uint64_t x, int r) {return (x << r) | (x >> (64 - r));};
+    auto mix = [&](uint64_t acc, uint64_t word) {return rotl(acc + word * prime2, 31) * prime1;};
+
+    // Four independent lanes over 32-byte stripes
+    uint64_t lanes[4] = {size + prime1, size ^ prime2, size - prime1, ~size};
+    size_t i = 0;
+    for (; i+32 <= size; i += 32) {
+        for (int l = 0; l < 4; l++) {
+            uint64_t word;
+            memcpy(&word, data+i+8*l, sizeof(uint64_t));
+            lanes[l] = mix(lanes[l], word);
+        }
+    }
+    uint64_t h = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18);
+    // Remaining bytes
+    for (; i+8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data+i, sizeof(uint64_t));
+        h = mix(h, word);
+    }
+    for (; i < size; i++) h = mix(h, data[i]);
+
+    // Final avalanche
+    h ^= h >> 33; h *= prime2;
+    h ^= h >> 29; h *= prime1;
+    h ^= h >> 32;
+    return h;
+}
+
+std::string FormulaCache::getEntryPath(uint64_t key) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016lx.mfc", (unsigned long) key);
+    return _directory + "/" + name;
+}
@@ -0,0 +1,67 @@
+
+#ifndef DOMPASCH_MALLOB_FORMULA_CACHE_HPP
+#define DOMPASCH_MALLOB_FORMULA_CACHE_HPP
+
+#include <string>
+#include <cstdint>
+#include <sys/types.h>
+
+#include "data/job_description.hpp"
+#include "util/robin_hood.hpp"
+#include "util/sys/threading.hpp"
+
+/*
+On-disk cache of parsed formulae, keyed by the content of the formula file.
+Each entry is a file "<dir>/<key>.mfc" which consists of a FormulaCacheHeader
+followed by the formula's literals (with separation zeroes), i.e., exactly the
+formula payload of a JobDescription. Computing the key of a file requires
+hashing its content, which is done at most once for each unchanged file
+(identified by device, inode, size and modification time).
+Methods are thread-safe.
+*/
+class FormulaCache {
+
+public:
+    struct FormulaCacheHeader {
+        uint64_t magic;
+        uint64_t key;
+        uint64_t numLits;
+        int numVars;
+        int version;
+    };
+
+private:
+    struct FileStamp {
+        dev_t device;
+        ino_t inode;
+        off_t size;
+        int64_t mtimeNanos;
+        bool operator==(const FileStamp& other) const {
+            return device == other.device && inode == other.inode
+                && size == other.size && mtimeNanos == other.mtimeNanos;
+        }
+    };
+
+    std::string _directory;
+    robin_hood::unordered_node_map<std::string, std::pair<FileStamp, uint64_t>> _keys_by_path;
+    Mutex _keys_mutex;
+
+public:
+    // An empty directory disables the cache.
+    FormulaCache(const std::string& directory);
+    bool isEnabled() const {return !_directory.empty();}
+
+    // Computes the key of the provided file's content. Returns false if the file cannot be read.
+    bool getKey(const std::string& file, uint64_t& key);
+    // Initializes desc with the cached formula of the provided key. Returns false if there is none.
+    bool load(uint64_t key, JobDescription& desc);
+    // Writes the (fully initialized) formula of desc to the cache under the provided key.
+    bool store(uint64_t key, const JobDescription& desc);
+
+    static uint64_t hashContent(const uint8_t* data, size_t size);
+
+private:
+    std::string getEntryPath(uint64_t key) const;
+};
+
+#endif
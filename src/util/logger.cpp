@@ -35,8 +35,28 @@ public:
     }
 };
 
+// Defined before the main instance such that it is destructed after it
+AsyncLogWriter Logger::_async_writer;
 Logger Logger::_main_instance;
 
+// Appends formatted output to the buffer at position len, growing the buffer as necessary
+void vappendToLine(std::vector<char>& line, size_t& len, const char* fmt, va_list& args) {
+    va_list argsCopy; va_copy(argsCopy, args);
+    int n = vsnprintf(line.data()+len, line.size()-len, fmt, args);
+    if (n >= 0 && (size_t)n >= line.size()-len) {
+        line.resize(len+n+1);
+        vsnprintf(line.data()+len, line.size()-len, fmt, argsCopy);
+    }
+    va_end(argsCopy);
+    if (n > 0) len += n;
+}
+void appendToLine(std::vector<char>& line, size_t& len, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vappendToLine(line, len, fmt, args);
+    va_end(args);
+}
+
 void log(int options, const char* str, ...) {
     va_list args;
     va_start(args, str);
@@ -52,7 +72,8 @@ bool log_return_false(const char* str, ...) {
     return false;
 }
 
-void Logger::init(int rank, int verbosity, bool coloredOutput, bool quiet, bool cPrefix, std::string logDir) {
+void Logger::init(int rank, int verbosity, bool coloredOutput, bool quiet, bool cPrefix, std::string logDir, 
+        bool asynchronous) {
     _main_instance._rank = rank;
     _main_instance._verbosity = std::min(7, verbosity);
     _main_instance._colored_output = coloredOutput;
@@ -74,6 +95,8 @@ void Logger::init(int rank, int verbosity, bool coloredOutput, bool quiet, bool
         _main_instance.log(V0_CRIT, "ERROR while trying to open log file \"%s\"", 
             _main_instance._log_filename.c_str());
     }
+
+    if (asynchronous) _async_writer.start(rank, _main_instance._log_cfile, !quiet);
 }
 Logger::Logger(Logger&& other) :
     _log_directory(std::move(other._log_directory)), _log_filename(std::move(other._log_filename)), 
@@ -98,6 +121,13 @@ Logger& Logger::operator=(Logger&& other) {
     return *this;
 }
 Logger::~Logger() {
+    // Write all buffered lines before the main log file is closed
+    if (this == &_main_instance) _async_writer.stop();
+    if (_log_cfile != nullptr && _async_writer.isRunning()) {
+        // The writer thread may still hold lines for this file
+        _async_writer.close(_log_cfile);
+        _log_cfile = nullptr;
+    }
     flush();
     if (_log_cfile != nullptr) fclose(_log_cfile);
 }
@@ -142,6 +172,7 @@ bool Logger::fail(unsigned int options, const char* str, ...) const {
 }
 
 void Logger::flush() const {
+    if (_async_writer.isRunning()) _async_writer.flush();
     if (!_quiet) fflush(stdout);
     if (_log_cfile != nullptr) fflush(_log_cfile);
 }
@@ -184,6 +215,15 @@ void Logger::log(va_list& args, unsigned int options, const char* str) const {
         otherRank = va_arg(args, int);
     }
 
+    if (_async_writer.isRunning()) {
+        if (verbosity != V0_CRIT) {
+            logAsynchronously(args, verbosity, prefix, otherRank, withDestRank, str);
+            return;
+        }
+        // Critical messages are written immediately, after all preceding messages
+        _async_writer.flush();
+    }
+
     // Colored output, if applicable
     if (!_quiet && _colored_output) {
         if (verbosity == V0_CRIT) {
@@ -224,4 +264,29 @@ void Logger::log(va_list& args, unsigned int options, const char* str) const {
     if (!_quiet && _colored_output) {
         std::cout << Modifier(Code::FG_DEFAULT);
     }
-}
\ No newline at end of file
+}
+
+void Logger::logAsynchronously(va_list& args, int verbosity, bool prefix, int otherRank, bool withDestRank, 
+        const char* str) const {
+
+    // Assemble the full line in a thread-local buffer
+    thread_local std::vector<char> line(1024);
+    size_t len = 0;
+
+    // Timestamp and node rank
+    if (prefix) {
+        if (_c_prefix) appendToLine(line, len, "c ");
+        appendToLine(line, len, "%.3f %i%s ", Timer::elapsedSeconds(), _rank, _line_prefix.c_str());
+    }
+
+    // logging message
+    vappendToLine(line, len, str, args);
+    if (otherRank >= 0) appendToLine(line, len, " %s [%i]\n", withDestRank ? "=>" : "<=", otherRank);
+
+    int color = 0;
+    if (!_quiet && _colored_output) {
+        color = verbosity == V0_CRIT ? Code::FG_LIGHT_RED : verbosity == V1_WARN ? Code::FG_YELLOW 
+            : verbosity == V2_INFO ? Code::FG_WHITE : Code::FG_LIGHT_GRAY;
+    }
+    _async_writer.enqueue(_log_cfile, !_quiet, color, line.data(), len);
+}
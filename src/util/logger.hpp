@@ -17,6 +17,7 @@
 #include "util/sys/timer.hpp"
 #include "util/sys/threading.hpp"
 #include "util/sys/proc.hpp"
+#include "util/async_log_writer.hpp"
 
 #define V0_CRIT 0
 #define V1_WARN 1
@@ -34,12 +35,15 @@ class Logger {
 
 // Singleton for main console instance
 private:
+    // Backend for asynchronous logging (if enabled), shared by all instances
+    static AsyncLogWriter _async_writer;
     static Logger _main_instance;
     Logger() {}
     Logger(const Logger& other) = delete;
     Logger& operator=(const Logger& other) = delete;
 public:
-    static void init(int rank, int verbosity, bool coloredOutput, bool quiet, bool cPrefix, std::string logDir=".");
+    static void init(int rank, int verbosity, bool coloredOutput, bool quiet, bool cPrefix, std::string logDir=".", 
+            bool asynchronous=false);
     static Logger& getMainInstance() {
         return _main_instance;
     }
@@ -81,6 +85,8 @@ public:
 private:
 
     void log(va_list& args, unsigned int options, const char* str) const;
+    void logAsynchronously(va_list& args, int verbosity, bool prefix, int otherRank, bool withDestRank, 
+            const char* str) const;
 };
 
 void log(int options, const char* str, ...);
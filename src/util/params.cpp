@@ -21,13 +21,22 @@ const char* OPTIONS =
     "\n-T=<time-limit>       Run entire system for at most x seconds (x >= 0; 0: run indefinitely)"
 
     "\n\nSystem options:"
+    "\n-ajpw=<num-jobs>      Max. number of jobs which are active on each worker at the same time (int x >= 1);"
+    "\n                      each active job gets floor(t/x) threads, and balancing distributes x slots per worker"
     "\n-appmode=<mode>       Application mode: \"fork\" (spawn child process for each job on each MPI process)"
     "\n                      or \"thread\" (execute jobs in separate threads but within the same process)"
     "\n-delaymonkey[=<0|1>]  Small chance for each MPI call to block for some random amount of time"
+    "\n-dcs=<kilobytes>      Transfer job descriptions in chunks of at most <kilobytes> kB (int x >= 1)"
+    "\n-fcd=<directory>      Cache parsed formulae in binary form in <directory>, keyed by file content,"
+    "\n                      and look up this cache before parsing a job's formula (empty: no caching)"
     "\n-jc=<size>            Size of job cache for suspended yet unfinished jobs (int x >= 0; 0: no limit)"
     "\n-latencymonkey[=<0|1>]    Block all MPI_Isend operations by a small randomized amount of time"
+    "\n-mbpi=<num-msgs>      Max. number of received messages to process per loop cycle of worker main thread"
+    "\n                      (int x >= 1); the main thread only sleeps if no messages were processed"
     "\n-mmpi[=<0|1>]         Monitor MPI: Launch an additional thread per process checking when the main thread"
     "\n                      is inside some MPI call"
+    "\n-pps=<num-procs>      Pre-spawn <num-procs> idle SAT processes per worker which are bound to jobs on demand"
+    "\n                      (only relevant if -appmode=fork; 0: spawn a process for each job)"
     "\n-sleep=<micros>       Sleep provided number of microseconds between loop cycles of worker main thread"
     "\n-slpp=<limit>         Size limit per process: no more than max(1, floor(<limit>/<jobsize>)) threads"
     "\n                      are spawned per process (0: no limit)"
@@ -36,6 +45,8 @@ const char* OPTIONS =
     "\n-yield[=<0|1>]        Yield manager thread whenever there are no new messages"
 
     "\n\nOutput options:"
+    "\n-alog[=<0|1>]         Asynchronous logging: a separate thread writes log lines in batches;"
+    "\n                      lines are dropped (and counted) if a thread's log buffer is full"
     "\n-colors[=<0|1>]       Colored terminal output based on messages' verbosity"
     "\n-log=<log-dir>        Directory to save logs in"
     "\n-q[=<0|1>]            Quiet mode: do not log to stdout besides critical information"
@@ -63,11 +74,19 @@ const char* OPTIONS =
     "\n-s=<comm-period>      Do job-internal communication every t seconds (t >= 0, 0: do not communicate)"
 
     "\n\nSAT solving application options:"
+    "\n-acs[=<0|1>]          Adaptive clause sharing: each job's root tunes the sharing period and the clause buffer"
+    "\n                      base size based on buffer fill, duplicate rate and all-reduce latency"
+    "\n-acsf=<factor>        Adaptive clause sharing may deviate from -s and -cbbs at most by <factor> (x >= 1)"
     "\n-aod[=<0|1>]          Add additional old diversifiers to Lingeling"
     "\n-cbbs=<size>          Clause buffer base size in integers (default: 1500)"
     "\n-cbdf=<factor>        Clause buffer discount factor: reduce buffer size per node by <factor> each depth"
     "\n                      (0 < factor <= 1.0; default: 1.0)"
-    "\n-cfhl=<secs>          Set clause filter half life of clauses until forgotten (integer; 0: no forgetting)"
+    "\n-cbenc=<raw|varint>   Clause buffer encoding for communication: plain integers (\"raw\") or sorted,"
+    "\n                      delta-encoded literals written as variable-length integers (\"varint\")"
+    "\n-cbsel=<len|lbd>      Clause buffer selection: fill clause buffers with the shortest clauses first (\"len\")"
+    "\n                      or with the clauses of lowest LBD first, shortest first among equal LBD (\"lbd\")"
+    "\n-cfhl=<secs>          Set clause filter half life: every x seconds, forget the oldest generation of"
+    "\n                      registered clauses (integer; 0: no forgetting)"
     "\n-fhlbd=<max-length>   Final hard LBD limit: After max. number of clause prod. increases, this MUST be fulfilled"
     "\n                      for any clause to be shared"
     "\n-fslbd=<max-length>   Final soft LBD limit: After max. number of clause prod. increases, this must be fulfilled"
@@ -86,8 +105,18 @@ const char* OPTIONS =
 #else
     "\n                      l=lingeling c=cadical"
 #endif
+    "\n-scf[=<0|1>]          Shared clause filter: use a single clause filter for all solvers of a process (up to 64 solvers)"
+    "\n                      (memory independent of #threads) instead of one filter per solver"
     "\n-smcl=<max-length>    Soft maximum clause length: Only share clauses up to some length (int x >= 0; 0: no limit)"
     "\n                      except a clause has special solver-dependent qualities"
+
+    "\n\nSimulator options (mallob_sim):"
+    "\n-sim-latency=<secs>   Latency of each simulated message in seconds (x >= 0)"
+    "\n-sim-ranks=<num>      Number of simulated worker ranks (int x >= 1)"
+    "\n-sim-sample-period=<secs> Report utilization and job volumes every x simulated seconds (x > 0)"
+    "\n-sim-scenario=<file>  Scenario file to replay, one job \"ID Arv Prio File\" per line"
+    "\n-sim-seed=<seed>      Random seed of the simulation (int)"
+    "\n-sim-work=<secs>      CPU seconds a simulated job needs to finish (x > 0)"
     "\n";
 
 /**
@@ -117,18 +146,26 @@ void Parameters::init(int argc, char** argv) {
 }
 
 void Parameters::setDefaults() {
+    setParam("acs", "0"); // adaptive clause sharing
+    setParam("acsf", "4"); // max. deviation factor of adaptive clause sharing from -s and -cbbs
+    setParam("ajpw", "1"); // active jobs per worker
     setParam("aod", "0"); // add old diversifiers (to lgl)
+    setParam("alog", "0"); // asynchronous logging
     setParam("appmode", "fork"); // application mode (fork or thread)
     setParam("ba", "4"); // num bounce alternatives (only relevant if -derandomize)
     setParam("bm", "ed"); // event-driven balancing (ed = event-driven, fp = fixed-period)
     setParam("c", "1"); // num clients
     setParam("cbbs", "1500"); // clause buffer base size
     setParam("cbdf", "0.75"); // clause buffer discount factor
+    setParam("cbenc", "raw"); // clause buffer encoding for communication (raw or varint)
+    setParam("cbsel", "len"); // clause buffer selection policy (len or lbd)
     setParam("cfhl", "60"); // clause buffer half life
     setParam("cg", "1"); // continuous growth
     setParam("colors", "0"); // colored terminal output
     setParam("delaymonkey", "0"); // Small chance for each MPI call to block for some random amount of time
+    setParam("dcs", "1024"); // job description chunk size (kilobytes)
     setParam("derandomize", "1"); // derandomize job bouncing
+    setParam("fcd", ""); // formula cache directory (empty = no caching)
     setParam("g", "5.0"); // job demand growth interval
     //setParam("h"); setParam("help"); // print usage
     setParam("icpr", "0.8"); // increase clause production ratio
@@ -139,11 +176,13 @@ void Parameters::setDefaults() {
     setParam("latencymonkey", "0"); // Block all MPI_Isend operations by a small randomized amount of time 
     setParam("log", "."); // logging directory
     setParam("lbc", "0"); // leaky bucket client parameter (0 = no leaky bucket, jobs enter by time) 
+    setParam("mbpi", "16"); // max. number of messages to process per main loop cycle
     setParam("md", "0"); // maximum demand per job (0 = no limit)
     setParam("slpp", "0"); // size limit per process (0 = no limit)
     setParam("mmpi", "0"); // monitor MPI
     setParam("mono", ""); // mono instance solving mode (if nonempty)
     setParam("phasediv", "1"); // Do phase-based diversification (in addition to native)
+    setParam("pps", "0"); // number of pre-spawned SAT processes (0 = spawn on demand)
     setParam("p", "0.1"); // minimum interval between rebalancings (seconds)
     setParam("q", "0"); // no logging to stdout
     setParam("r", ROUNDING_BISECTION); // rounding of assignments (prob = probabilistic, bisec = iterative bisection)
@@ -151,6 +190,13 @@ void Parameters::setDefaults() {
     setParam("s", "1.0"); // job communication period (seconds)
     setParam("s2f", ""); // write solutions to file (file path, or empty string for no writing)
     setParam("satsolver", "l"); // which SAT solvers to cycle through
+    setParam("scf", "0"); // shared clause filter for all solvers of a process
+    setParam("sim-latency", "0.0001"); // simulator: message latency (seconds)
+    setParam("sim-ranks", "16"); // simulator: number of simulated worker ranks
+    setParam("sim-sample-period", "1.0"); // simulator: period of utilization and volume reports (seconds)
+    setParam("sim-scenario", ""); // simulator: scenario file to replay
+    setParam("sim-seed", "0"); // simulator: random seed
+    setParam("sim-work", "60"); // simulator: CPU seconds of work per job
     setParam("sleep", "100"); // microsecs to sleep in between worker main loop cycles
     setParam("T", "0"); // total time to run the system (0 = no limit)
     setParam("t", "1"); // num threads per node
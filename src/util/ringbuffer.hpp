@@ -15,22 +15,28 @@ class RingBuffer {
 private:
     uint8_t* _data;
     ringbuf_t* _ringbuf;
-    ringbuf_worker_t* _producer;
+    std::vector<ringbuf_worker_t*> _producers;
     size_t _capacity;
 
 public:
-    RingBuffer(size_t size) : _capacity(size) {
+    RingBuffer(size_t size, int numProducers = 1) : _capacity(size) {
         size_t ringbufSize;
-        ringbuf_get_sizes(/*nworkers=*/1, &ringbufSize, nullptr);
+        ringbuf_get_sizes(/*nworkers=*/numProducers, &ringbufSize, nullptr);
         _ringbuf = (ringbuf_t*)malloc(ringbufSize);
-        ringbuf_setup(_ringbuf, /*nworkers=*/1, size);
-        _producer = ringbuf_register(_ringbuf, /*worker_id=*/0);
+        ringbuf_setup(_ringbuf, /*nworkers=*/numProducers, size);
+        for (int i = 0; i < numProducers; i++) {
+            _producers.push_back(ringbuf_register(_ringbuf, /*worker_id=*/i));
+        }
         _data = (uint8_t*)malloc(sizeof(int)*size);
     }
+    RingBuffer(const RingBuffer& other) = delete;
+    RingBuffer& operator=(const RingBuffer& other) = delete;
 
-    bool produce(const int* data, size_t size, bool addSeparationZero) {
+    // Lock-free; each producer ID must be used by at most one thread at a time
+    bool produce(const int* data, size_t size, bool addSeparationZero, int producerId = 0) {
         
-        ssize_t offset = ringbuf_acquire(_ringbuf, _producer, size + (addSeparationZero ? 1 : 0));
+        ringbuf_worker_t* producer = _producers[producerId];
+        ssize_t offset = ringbuf_acquire(_ringbuf, producer, size + (addSeparationZero ? 1 : 0));
         if (offset == -1) return false;
         
         memcpy(_data+sizeof(int)*offset, data, sizeof(int)*size);
@@ -39,7 +45,7 @@ public:
             memcpy(_data+sizeof(int)*(offset+size), &zeroToAppend, sizeof(int));
         }
         
-        ringbuf_produce(_ringbuf, _producer);
+        ringbuf_produce(_ringbuf, producer);
         
         return true;
     }
@@ -58,6 +64,23 @@ public:
         return true;
     }
 
+    // Append all data which is ready to be consumed to the given vector.
+    // Returns the number of appended elements.
+    size_t consumeAll(std::vector<int>& elems) {
+
+        size_t numConsumed = 0;
+        size_t offset;
+        size_t len;
+        while ((len = ringbuf_consume(_ringbuf, &offset)) > 0) {
+            size_t prevSize = elems.size();
+            elems.resize(prevSize + len);
+            memcpy(elems.data()+prevSize, _data+sizeof(int)*offset, len*sizeof(int));
+            ringbuf_release(_ringbuf, len);
+            numConsumed += len;
+        }
+        return numConsumed;
+    }
+
     size_t getCapacity() const {
         return _capacity;
     }
@@ -1,26 +1,33 @@
-
 #include <ctype.h>
 #include <stdio.h>
+#include <string.h>
 #include <iostream>
+#include <thread>
+#include <algorithm>
 #include <assert.h>
 #include <sys/stat.h>
 #include <sys/mman.h>
 #include <fcntl.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include <lzma.h>
+#include <zlib.h>
+#ifdef MALLOB_USE_ZSTD
+#include <zstd.h>
+#endif
 
 #include "sat_reader.hpp"
 #include "util/sys/terminator.hpp"
+#include "util/logger.hpp"
+
+// Minimum number of bytes to parse per thread if the number of threads is chosen automatically
+#define MIN_BYTES_PER_THREAD (8*1024*1024)
+// Size of blocks of compressed input and of decompressed output
+#define DECOMPRESSION_BLOCK_SIZE (1024*1024)
 
 bool SatReader::read(JobDescription& desc) {
 
-	FILE* pipe = nullptr;
-	if ((_filename.size() > 3 && _filename.substr(_filename.size()-3, 3) == ".xz")
-		|| (_filename.size() > 5 && _filename.substr(_filename.size()-5, 5) == ".lzma")) {
-		// Decompress, read output
-		auto command = "xz -c -d " + _filename;
-		pipe = popen(command.c_str(), "r");
-		if (pipe == nullptr) return false;
-	}
-	
 	desc.beginInitialization();
 	
 	_sign = 1;
@@ -29,37 +36,17 @@ bool SatReader::read(JobDescription& desc) {
 	_num = 0;
 	_max_var = 0;
 
-	if (pipe == nullptr) {
-		// Read file with mmap
-		int fd = open(_filename.c_str(), O_RDONLY);
-		if (fd == -1) return false;
-		char* f;
-
-		off_t size;
-    	struct stat s;
-		int status = stat(_filename.c_str(), &s);
-		if (status == -1) return false;
-		size = s.st_size;
-		desc.reserveSize(size / sizeof(int));
-
-		f = (char *) mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
-		for (int i = 0; i < size; i++) {
-			process(f[i], desc);
-		}
-		munmap(f, size);
-		close(fd);
-
+	bool success;
+	if (hasSuffix(".xz") || hasSuffix(".lzma")) {
+		success = readXz(desc);
+	} else if (hasSuffix(".gz")) {
+		success = readGz(desc);
+	} else if (hasSuffix(".zst")) {
+		success = readZst(desc);
 	} else {
-		// Read every character of the formula (in a buffered manner)
-		char buffer[4096] = {'\0'};
-		while (!Terminator::isTerminating() && fgets(buffer, sizeof(buffer), pipe)) {
-			size_t pos = 0;
-			while (buffer[pos] != '\0') {
-				int c = buffer[pos++];
-				process(c, desc);
-			}
-		}
+		success = readUncompressed(desc);
 	}
+	if (!success) return false;
 
 	if (_began_num) { // write final zero (without newline)
 		desc.addLiteral(0);
@@ -68,7 +55,301 @@ bool SatReader::read(JobDescription& desc) {
 	desc.setNumVars(_max_var);
 	desc.endInitialization();
 
-	if (pipe != nullptr) pclose(pipe);
+	return true;
+}
+
+bool SatReader::hasSuffix(const std::string& suffix) const {
+	return _filename.size() > suffix.size() 
+		&& _filename.compare(_filename.size()-suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool SatReader::readUncompressed(JobDescription& desc) {
+
+	// Read file with mmap
+	int fd = open(_filename.c_str(), O_RDONLY);
+	if (fd == -1) return false;
+	char* f;
 
+	off_t size;
+	struct stat s;
+	int status = stat(_filename.c_str(), &s);
+	if (status == -1) return false;
+	size = s.st_size;
+
+	int numThreads = _num_threads;
+	if (numThreads <= 0) {
+		numThreads = std::min((off_t)std::max(1U, std::thread::hardware_concurrency()), 
+				size / MIN_BYTES_PER_THREAD);
+	}
+
+	f = (char *) mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (numThreads > 1) {
+		readInParallel(f, size, numThreads, desc);
+	} else {
+		desc.reserveSize(size / sizeof(int));
+		processBlock(f, size, desc);
+	}
+	munmap(f, size);
+	close(fd);
 	return true;
 }
+
+bool SatReader::readXz(JobDescription& desc) {
+
+	FILE* file = fopen(_filename.c_str(), "rb");
+	if (file == nullptr) return false;
+
+	// Decoder for both .xz and legacy .lzma streams
+	lzma_stream strm = LZMA_STREAM_INIT;
+	if (lzma_auto_decoder(&strm, UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK) {
+		fclose(file);
+		return false;
+	}
+
+	std::vector<uint8_t> in(DECOMPRESSION_BLOCK_SIZE);
+	std::vector<uint8_t> out(DECOMPRESSION_BLOCK_SIZE);
+	strm.next_in = nullptr;
+	strm.avail_in = 0;
+	strm.next_out = out.data();
+	strm.avail_out = out.size();
+	lzma_action action = LZMA_RUN;
+	bool success = true;
+
+	while (!Terminator::isTerminating()) {
+		if (strm.avail_in == 0 && action == LZMA_RUN) {
+			strm.next_in = in.data();
+			strm.avail_in = fread(in.data(), 1, in.size(), file);
+			if (ferror(file)) {
+				success = false;
+				break;
+			}
+			if (feof(file)) action = LZMA_FINISH;
+		}
+		lzma_ret ret = lzma_code(&strm, action);
+		if (strm.avail_out == 0 || ret != LZMA_OK) {
+			// Parse the decompressed block
+			processBlock((const char*) out.data(), out.size()-strm.avail_out, desc);
+			strm.next_out = out.data();
+			strm.avail_out = out.size();
+		}
+		if (ret == LZMA_STREAM_END) break;
+		if (ret != LZMA_OK) {
+			log(V1_WARN, "[WARN] Error %i while decompressing %s\n", ret, _filename.c_str());
+			success = false;
+			break;
+		}
+	}
+
+	lzma_end(&strm);
+	fclose(file);
+	return success;
+}
+
+bool SatReader::readGz(JobDescription& desc) {
+
+	gzFile file = gzopen(_filename.c_str(), "rb");
+	if (file == nullptr) return false;
+	gzbuffer(file, DECOMPRESSION_BLOCK_SIZE);
+
+	std::vector<char> out(DECOMPRESSION_BLOCK_SIZE);
+	int numRead = 0;
+	while (!Terminator::isTerminating() && (numRead = gzread(file, out.data(), out.size())) > 0) {
+		processBlock(out.data(), numRead, desc);
+	}
+	if (numRead < 0) {
+		int errnum;
+		log(V1_WARN, "[WARN] Error while decompressing %s: %s\n", _filename.c_str(), gzerror(file, &errnum));
+	}
+
+	gzclose(file);
+	return numRead >= 0;
+}
+
+bool SatReader::readZst(JobDescription& desc) {
+
+#ifdef MALLOB_USE_ZSTD
+	FILE* file = fopen(_filename.c_str(), "rb");
+	if (file == nullptr) return false;
+
+	ZSTD_DStream* dstream = ZSTD_createDStream();
+	ZSTD_initDStream(dstream);
+	std::vector<char> in(ZSTD_DStreamInSize());
+	std::vector<char> out(std::max(ZSTD_DStreamOutSize(), (size_t)DECOMPRESSION_BLOCK_SIZE));
+	bool success = true;
+
+	size_t numRead;
+	while (success && !Terminator::isTerminating() 
+			&& (numRead = fread(in.data(), 1, in.size(), file)) > 0) {
+		ZSTD_inBuffer input = {in.data(), numRead, 0};
+		while (input.pos < input.size) {
+			ZSTD_outBuffer output = {out.data(), out.size(), 0};
+			size_t ret = ZSTD_decompressStream(dstream, &output, &input);
+			if (ZSTD_isError(ret)) {
+				log(V1_WARN, "[WARN] Error while decompressing %s: %s\n", 
+					_filename.c_str(), ZSTD_getErrorName(ret));
+				success = false;
+				break;
+			}
+			processBlock(out.data(), output.pos, desc);
+		}
+	}
+	if (ferror(file)) success = false;
+
+	ZSTD_freeDStream(dstream);
+	fclose(file);
+	return success;
+#else
+	// No native support: decompress in an external process, read its output
+	auto command = "zstd -c -d " + _filename;
+	FILE* pipe = popen(command.c_str(), "r");
+	if (pipe == nullptr) return false;
+
+	std::vector<char> out(DECOMPRESSION_BLOCK_SIZE);
+	size_t numRead;
+	while (!Terminator::isTerminating() && (numRead = fread(out.data(), 1, out.size(), pipe)) > 0) {
+		processBlock(out.data(), numRead, desc);
+	}
+	return pclose(pipe) == 0 || Terminator::isTerminating();
+#endif
+}
+
+void SatReader::processBlock(const char* data, size_t size, JobDescription& desc) {
+	for (size_t i = 0; i < size; i++) {
+		process(data[i], desc);
+	}
+}
+
+void SatReader::readInParallel(const char* data, size_t size, int numThreads, JobDescription& desc) {
+
+	// Split the data into chunks, each beginning right after a line break
+	std::vector<size_t> bounds(numThreads+1, size);
+	bounds[0] = 0;
+	for (int t = 1; t < numThreads; t++) {
+		size_t pos = std::max(bounds[t-1], size / numThreads * t);
+		const char* nl = (const char*) memchr(data+pos, '\n', size-pos);
+		bounds[t] = nl == nullptr ? size : (nl-data)+1;
+	}
+	// Drop empty chunks such that the last chunk holds the end of the data
+	bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+	numThreads = bounds.size()-1;
+
+	// Parse each chunk in a separate thread
+	std::vector<ChunkResult> results(numThreads);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < numThreads; t++) {
+		threads.emplace_back([&, t]() {
+			parseChunk(data+bounds[t], data+bounds[t+1], results[t]);
+		});
+	}
+	for (auto& thread : threads) thread.join();
+
+	// Each chunk was parsed as if starting from the initial state.
+	// Verify that the preceding chunk did indeed end in that state
+	// (which may not be the case for some malformed input).
+	bool consistent = true;
+	for (int t = 0; t+1 < numThreads; t++) {
+		if (results[t].sign != 1 || results[t].num != 0) consistent = false;
+	}
+	if (!consistent) {
+		// Fall back to sequential parsing
+		desc.reserveSize(size / sizeof(int));
+		processBlock(data, size, desc);
+		return;
+	}
+
+	// Concatenate the parsed literals
+	size_t numLits = 0;
+	for (const auto& result : results) numLits += result.lits.size();
+	desc.reserveSize(numLits * sizeof(int));
+	for (auto& result : results) {
+		desc.addLiterals(result.lits.data(), result.lits.size());
+		result.lits = std::vector<int>();
+		_max_var = std::max(_max_var, result.maxVar);
+	}
+
+	// Adopt final state of the last chunk
+	// (all chunks but the last end with a line break)
+	const auto& last = results.back();
+	_sign = last.sign;
+	_num = last.num;
+	_began_num = last.beganNum;
+	_comment = last.comment;
+}
+
+/*
+Equivalent to calling process(c, desc) for each character c in [begin, end),
+beginning in the initial state, but writes literals into result.lits.
+Comment lines are skipped via memchr, and runs of digits are detected 
+with SIMD instructions (if available).
+*/
+void SatReader::parseChunk(const char* begin, const char* end, ChunkResult& result) {
+
+	auto& lits = result.lits;
+	lits.reserve((end-begin) / 4);
+	int sign = 1;
+	int num = 0;
+	int maxVar = 0;
+	bool beganNum = false;
+	bool comment = false;
+
+	const char* p = begin;
+	while (p < end) {
+		char c = *p;
+		switch (c) {
+		case '\n':
+			if (beganNum) {
+				assert(num == 0);
+				lits.push_back(0);
+				beganNum = false;
+			}
+			p++;
+			break;
+		case 'p':
+		case 'c': {
+			// Skip comment until (excluding) the next line break
+			const char* nl = (const char*) memchr(p, '\n', end-p);
+			comment = (nl == nullptr);
+			p = (nl == nullptr ? end : nl);
+			break;
+		}
+		case ' ':
+			if (beganNum) {
+				maxVar = std::max(maxVar, num);
+				lits.push_back(sign * num);
+				num = 0;
+				beganNum = false;
+			}
+			sign = 1;
+			p++;
+			break;
+		case '-':
+			sign = -1;
+			beganNum = true;
+			p++;
+			break;
+		default: {
+			int len = 1;
+#ifdef __SSE2__
+			if (p+16 <= end) {
+				// Find length of the run of digits beginning at p
+				__m128i chars = _mm_loadu_si128((const __m128i*) p);
+				__m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0'-1)), 
+						_mm_cmplt_epi8(chars, _mm_set1_epi8('9'+1)));
+				unsigned int nonDigits = ~_mm_movemask_epi8(isDigit) & 0xFFFF;
+				len = std::max(1, nonDigits == 0 ? 16 : __builtin_ctz(nonDigits));
+			}
+#endif
+			for (int i = 0; i < len; i++) num = num*10 + (p[i]-'0');
+			beganNum = true;
+			p += len;
+			break;
+		}
+		}
+	}
+
+	result.maxVar = maxVar;
+	result.sign = sign;
+	result.num = num;
+	result.beganNum = beganNum;
+	result.comment = comment;
+}
@@ -20,8 +20,11 @@ private:
 	int _num = 0;
 	int _max_var = 0;
 
+    // Number of threads to parse an uncompressed file with (0: choose automatically)
+    int _num_threads;
+
 public:
-    SatReader(std::string filename) : _filename(filename) {}
+    SatReader(std::string filename, int numThreads = 0) : _filename(filename), _num_threads(numThreads) {}
     bool read(JobDescription& desc);
     inline void process(char c, JobDescription& desc) {
 
@@ -59,6 +62,26 @@ public:
             break;
         }
     }
+
+private:
+    bool hasSuffix(const std::string& suffix) const;
+    bool readUncompressed(JobDescription& desc);
+    // In-process streaming decompression, parsing each decompressed block
+    bool readXz(JobDescription& desc);
+    bool readGz(JobDescription& desc);
+    bool readZst(JobDescription& desc);
+    void processBlock(const char* data, size_t size, JobDescription& desc);
+
+    struct ChunkResult {
+        std::vector<int> lits;
+        int maxVar = 0;
+        int sign = 1;
+        int num = 0;
+        bool beganNum = false;
+        bool comment = false;
+    };
+    void readInParallel(const char* data, size_t size, int numThreads, JobDescription& desc);
+    static void parseChunk(const char* begin, const char* end, ChunkResult& result);
 };
 
 #endif
\ No newline at end of file
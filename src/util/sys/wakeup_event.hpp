@@ -0,0 +1,50 @@
+
+#ifndef DOMPASCH_MALLOB_WAKEUP_EVENT_HPP
+#define DOMPASCH_MALLOB_WAKEUP_EVENT_HPP
+
+#include <atomic>
+#include <climits>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+/*
+Futex-based event counter which may be placed inside a block of shared memory
+to wake up a thread of another process (or of the same process) without signals.
+A waiting party first reads current(), then checks for work, and finally calls
+wait() with the read value: Any notify() in between is not lost.
+*/
+struct WakeupEvent {
+
+    std::atomic_int counter;
+
+    void reset() {
+        counter.store(0, std::memory_order_release);
+    }
+
+    int current() const {
+        return counter.load(std::memory_order_acquire);
+    }
+
+    void notify() {
+        counter.fetch_add(1, std::memory_order_acq_rel);
+        syscall(SYS_futex, (int*)&counter, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+
+    // Block until the event was notified since current() returned "seen"
+    // or until the timeout (if non-negative) has passed.
+    void wait(int seen, long timeoutMicros = -1) {
+        if (current() != seen) return;
+        if (timeoutMicros < 0) {
+            syscall(SYS_futex, (int*)&counter, FUTEX_WAIT, seen, nullptr, nullptr, 0);
+        } else {
+            timespec timeout;
+            timeout.tv_sec = timeoutMicros / (1000*1000);
+            timeout.tv_nsec = (timeoutMicros % (1000*1000)) * 1000;
+            syscall(SYS_futex, (int*)&counter, FUTEX_WAIT, seen, &timeout, nullptr, 0);
+        }
+    }
+};
+
+#endif
@@ -12,11 +12,13 @@
 #include "app/sat/threaded_sat_job.hpp"
 #include "app/sat/forked_sat_job.hpp"
 #include "app/sat/sat_constants.h"
+#include "app/sat/sat_process_pool.hpp"
 
 #include "balancing/event_driven_balancer.hpp"
 #include "comm/mpi_monitor.hpp"
 #include "data/serializable.hpp"
 #include "data/job_description.hpp"
+#include "data/job_placement.hpp"
 #include "util/sys/process.hpp"
 #include "util/sys/proc.hpp"
 #include "util/sys/timer.hpp"
@@ -100,6 +102,11 @@ void Worker::init() {
     });
     MyMpi::beginListening();
 
+    // Pre-spawn idle SAT processes which are later bound to jobs
+    if (_params.getParam("appmode") == "fork") {
+        SatProcessPool::init(_params, _world_rank);
+    }
+
     // Send warm-up messages with your pseudorandom bounce destinations
     if (_params.isNotNull("derandomize") && _params.isNotNull("warmup")) {
         IntVec payload({1, 2, 3, 4, 5, 6, 7, 8});
@@ -169,7 +176,7 @@ void Worker::mainProgram() {
     while (!checkTerminate(time)) {
         
         // Poll received messages, make progress in sent messages
-        _msg_handler.pollMessages(time);
+        size_t numProcessedMsgs = _msg_handler.pollMessages(time);
         MyMpi::testSentHandles();
 
         if (time - lastMemCheckTime > memCheckPeriod) {
@@ -191,8 +198,8 @@ void Worker::mainProgram() {
                 log(V3_VERB, "mainthread cpuratio=%.3f sys=%.3f\n", cpuShare, sysShare);
             }
 
-            // For the current job
-            if (!_job_db.isIdle()) _job_db.getActive().appl_dumpStats();
+            // For the current jobs
+            for (Job* job : _job_db.getActiveJobs()) job->appl_dumpStats();
         }
 
         // Advance load balancing operations
@@ -220,21 +227,26 @@ void Worker::mainProgram() {
             }
         }
 
-        // Check active job
+        // Check active jobs
         if (time - lastJobCheckTime >= jobCheckPeriod) {
             lastJobCheckTime = time;
 
-            if (_job_db.isIdle()) {
-                _sys_state.setLocal(SYSSTATE_BUSYRATIO, 0.0f); // busy nodes
-                _sys_state.setLocal(SYSSTATE_NUMJOBS, 0.0f); // active jobs
+            // Replace pooled SAT processes which have been bound to jobs
+            SatProcessPool::refill();
 
-            } else {
-                Job &job = _job_db.getActive();
-                int id = job.getId();
-                bool isRoot = job.getJobTree().isRoot();
+            // Copy job IDs: a timeout removes the job from the active jobs
+            std::vector<int> activeJobIds;
+            int numActiveRoots = 0;
+            for (Job* job : _job_db.getActiveJobs()) {
+                activeJobIds.push_back(job->getId());
+                if (job->getJobTree().isRoot()) numActiveRoots++;
+            }
+            _sys_state.setLocal(SYSSTATE_BUSYRATIO, _job_db.getLoad()); // busy nodes (fraction of occupied slots)
+            _sys_state.setLocal(SYSSTATE_NUMJOBS, numActiveRoots); // active jobs
 
-                _sys_state.setLocal(SYSSTATE_BUSYRATIO, 1.0f); // busy nodes
-                _sys_state.setLocal(SYSSTATE_NUMJOBS, isRoot ? 1.0f : 0.0f); // active jobs
+            for (int id : activeJobIds) {
+                Job &job = _job_db.get(id);
+                bool isRoot = job.getJobTree().isRoot();
 
                 bool abort = false;
                 if (isRoot) abort = _job_db.checkComputationLimits(id);
@@ -272,8 +284,11 @@ void Worker::mainProgram() {
             _sys_state.setLocal(SYSSTATE_SPAWNEDREQUESTS, 0); // reset #requests
         }
 
-        if (sleepMicrosecs > 0) usleep(sleepMicrosecs);
-        if (doYield) std::this_thread::yield();
+        // Only sleep / yield if there is no further work in terms of messages
+        if (numProcessedMsgs == 0 && !_msg_handler.hasUnprocessedMessages()) {
+            if (sleepMicrosecs > 0) usleep(sleepMicrosecs);
+            if (doYield) std::this_thread::yield();
+        }
 
         time = Timer::elapsedSeconds();
     }
@@ -312,7 +327,7 @@ void Worker::handleAcceptAdoptionOffer(MessageHandle& handle) {
         // Full transfer of job description is required:
         // Send ACK to parent and receive full job description
         log(V4_VVER, "Will receive desc. of #%i, size %i\n", req.jobId, sig.getTransferSize());
-        MyMpi::irecv(MPI_COMM_WORLD, handle.source, MSG_SEND_JOB_DESCRIPTION, sig.getTransferSize()); // to be received later
+        beginDescriptionTransfer(req.jobId, handle.source, sig.getTransferSize()); // to be received later
         MyMpi::isend(MPI_COMM_WORLD, handle.source, MSG_CONFIRM_ADOPTION, req);
     } else {
         _job_db.uncommit(req.jobId);
@@ -335,6 +350,18 @@ void Worker::handleConfirmJobRevisionDetails(MessageHandle& handle) {
 void Worker::handleConfirmAdoption(MessageHandle& handle) {
     JobRequest req = Serializable::get<JobRequest>(handle.getRecvData());
 
+    // Description of the job is still arriving: relay its chunks to the new child
+    if (canRelayDescription(req, /*alreadyAccepted=*/true)) {
+        auto& transfer = *_incoming_description;
+        transfer.relayTargets.push_back(handle.source);
+        relayDescriptionChunks(handle.source, 0, transfer.numCompleteChunks);
+        log(LOG_ADD_DESTRANK | V4_VVER, "Relay desc. of %s", handle.source, 
+                _job_db.toStr(req.jobId, req.requestedNodeIndex).c_str());
+        auto relative = _job_db.get(req.jobId).getJobTree().setChild(handle.source, req.requestedNodeIndex);
+        if (relative == JobTree::TreeRelative::NONE) assert(req.requestedNodeIndex == 0);
+        return;
+    }
+
     // If job offer is obsolete, send a stub description containing the job id ONLY
     if (_job_db.isAdoptionOfferObsolete(req, /*alreadyAccepted=*/true)) {
         // Obsolete request
@@ -345,7 +372,16 @@ void Worker::handleConfirmAdoption(MessageHandle& handle) {
     Job& job = _job_db.get(req.jobId);
 
     // Retrieve and send concerned job description
-    MyMpi::isend(MPI_COMM_WORLD, handle.source, MSG_SEND_JOB_DESCRIPTION, job.getSerializedDescription());
+    auto desc = job.getSerializedDescription();
+    if (handle.source == _world_rank) {
+        MyMpi::isend(MPI_COMM_WORLD, handle.source, MSG_SEND_JOB_DESCRIPTION, desc);
+    } else {
+        // Send description in chunks which the receiver assembles in place
+        for (size_t offset = 0; offset < desc->size(); offset += _desc_chunk_size) {
+            size_t size = std::min(_desc_chunk_size, desc->size() - offset);
+            MyMpi::isend(MPI_COMM_WORLD, handle.source, MSG_SEND_JOB_DESCRIPTION, desc, offset, size);
+        }
+    }
     log(LOG_ADD_DESTRANK | V4_VVER, "Sent job desc. of %s", handle.source, job.toStr());
 
     // Mark new node as one of the node's children
@@ -418,9 +454,9 @@ void Worker::handleRequestNode(MessageHandle& handle, bool oneshot) {
 
     int removedJob;
     auto adoptionResult = _job_db.tryAdopt(req, oneshot, handle.source, removedJob);
-    if (adoptionResult == JobDatabase::ADOPT_FROM_IDLE || adoptionResult == JobDatabase::ADOPT_REPLACE_CURRENT) {
+    if (adoptionResult == JobPlacement::ADOPT_FROM_IDLE || adoptionResult == JobPlacement::ADOPT_REPLACE_CURRENT) {
 
-        if (adoptionResult == JobDatabase::ADOPT_REPLACE_CURRENT) {
+        if (adoptionResult == JobPlacement::ADOPT_REPLACE_CURRENT) {
             Job& job = _job_db.get(removedJob);
             IntPair pair(job.getId(), job.getIndex());
             MyMpi::isend(MPI_COMM_WORLD, job.getJobTree().getParentNodeRank(), MSG_NOTIFY_NODE_LEAVING_JOB, pair);
@@ -429,7 +465,7 @@ void Worker::handleRequestNode(MessageHandle& handle, bool oneshot) {
         // Adoption takes place
         std::string jobstr = _job_db.toStr(req.jobId, req.requestedNodeIndex);
         log(LOG_ADD_SRCRANK | V3_VERB, "ADOPT %s oneshot=%i", handle.source, req.toStr().c_str(), oneshot ? 1 : 0);
-        assert(_job_db.isIdle() || log_return_false("Adopting a job, but not idle!\n"));
+        assert(_job_db.hasFreeSlot() || log_return_false("Adopting a job, but no free slot!\n"));
 
         // Commit on the job, send a request to the parent
         bool fullTransfer = false;
@@ -446,7 +482,7 @@ void Worker::handleRequestNode(MessageHandle& handle, bool oneshot) {
         _job_db.commit(req);
         MyMpi::isend(MPI_COMM_WORLD, req.requestingNodeRank, MSG_OFFER_ADOPTION, req);
 
-    } else if (adoptionResult == JobDatabase::REJECT) {
+    } else if (adoptionResult == JobPlacement::REJECT) {
         if (oneshot) {
             log(LOG_ADD_DESTRANK | V5_DEBG, "decline oneshot request for %s", handle.source, 
                         _job_db.toStr(req.jobId, req.requestedNodeIndex).c_str());
@@ -536,7 +572,9 @@ void Worker::handleOfferAdoption(MessageHandle& handle) {
         Job &job = _job_db.get(req.jobId);
 
         // Check if node should be adopted or rejected
-        if (_job_db.isAdoptionOfferObsolete(req)) {
+        // (a job whose description is still arriving may adopt children to relay it to)
+        bool relay = canRelayDescription(req, /*alreadyAccepted=*/false);
+        if (!relay && _job_db.isAdoptionOfferObsolete(req)) {
             // Obsolete request
             log(LOG_ADD_SRCRANK | V3_VERB, "REJECT %s", handle.source, req.toStr().c_str());
             reject = true;
@@ -545,7 +583,8 @@ void Worker::handleOfferAdoption(MessageHandle& handle) {
             // Adopt the job
 
             // Send job signature
-            JobSignature sig(req.jobId, req.rootRank, req.revision, job.getSerializedDescription()->size());
+            size_t descSize = relay ? _incoming_description->data->size() : job.getSerializedDescription()->size();
+            JobSignature sig(req.jobId, req.rootRank, req.revision, descSize);
             MyMpi::isend(MPI_COMM_WORLD, handle.source, MSG_ACCEPT_ADOPTION_OFFER, sig);
 
             // If req.fullTransfer, then wait for the child to acknowledge having received the signature
@@ -604,6 +643,10 @@ void Worker::handleQueryVolume(MessageHandle& handle) {
 
     Job& job = _job_db.get(jobId);
     int volume = job.getVolume();
+    if (job.getState() != ACTIVE && _incoming_description && _incoming_description->jobId == jobId) {
+        // Description is still arriving (and being relayed)
+        volume = _incoming_description->volume;
+    }
     
     // Volume is unknown right now? Query parent recursively. 
     // (Answer will flood back to the entire subtree)
@@ -641,12 +684,119 @@ void Worker::handleNotifyResultObsolete(MessageHandle& handle) {
 }
 
 void Worker::handleSendJob(MessageHandle& handle) {
-    const auto& data = handle.getRecvData();
-    log(LOG_ADD_SRCRANK | V5_DEBG, "Receiving some desc. of size %i", handle.source, data.size());
-    int jobId = Serializable::get<int>(data);
-    initJob(jobId, std::shared_ptr<std::vector<uint8_t>>(
-        new std::vector<uint8_t>(handle.moveRecvData())
-    ), handle.source);
+
+    if (!handle.recvTarget) {
+        // Description was sent as a whole
+        const auto& data = handle.getRecvData();
+        log(LOG_ADD_SRCRANK | V5_DEBG, "Receiving some desc. of size %i", handle.source, data.size());
+        int jobId = Serializable::get<int>(data);
+        initJob(jobId, std::shared_ptr<std::vector<uint8_t>>(
+            new std::vector<uint8_t>(handle.moveRecvData())
+        ), handle.source);
+        return;
+    }
+
+    if (!_incoming_description || _incoming_description->data != handle.recvTarget) {
+        log(LOG_ADD_SRCRANK | V1_WARN, "[WARN] Unexpected chunk of some desc.", handle.source);
+        return;
+    }
+    auto& transfer = *_incoming_description;
+    log(LOG_ADD_SRCRANK | V5_DEBG, "Receiving chunk %i/%i of desc. of #%i", handle.source, 
+            transfer.numReceivedChunks+1, transfer.numChunks, transfer.jobId);
+
+    if (transfer.numReceivedChunks == 0 && handle.recvTargetSize == sizeof(int)) {
+        // Received a stub containing the job ID only: adoption is obsolete
+        int jobId = transfer.jobId;
+        _incoming_description.reset();
+        initJob(jobId, std::shared_ptr<std::vector<uint8_t>>(
+            new std::vector<uint8_t>(handle.recvTarget->data(), handle.recvTarget->data()+sizeof(int))
+        ), handle.source);
+        return;
+    }
+
+    transfer.numReceivedChunks++;
+    transfer.arrivedChunks[handle.recvTargetOffset / _desc_chunk_size] = true;
+
+    // Relay each chunk which extends the arrived prefix to the children known so far
+    size_t prevNumComplete = transfer.numCompleteChunks;
+    while (transfer.numCompleteChunks < transfer.numChunks 
+            && transfer.arrivedChunks[transfer.numCompleteChunks]) {
+        transfer.numCompleteChunks++;
+    }
+    for (int rank : transfer.relayTargets) {
+        relayDescriptionChunks(rank, prevNumComplete, transfer.numCompleteChunks);
+    }
+
+    if (transfer.numReceivedChunks == transfer.numChunks) {
+        // Description complete
+        DescriptionTransfer completed = std::move(transfer);
+        _incoming_description.reset();
+        initJob(completed.jobId, completed.data, completed.source);
+        return;
+    }
+    if (transfer.numReceivedChunks == 1) {
+        // The adoption is valid: query the job's volume right away so that
+        // the job can grow and relay the rest of its description to its children
+        MyMpi::isend(MPI_COMM_WORLD, transfer.source, MSG_QUERY_VOLUME, IntVec({transfer.jobId}));
+    }
+    postDescriptionChunks();
+}
+
+void Worker::beginDescriptionTransfer(int jobId, int source, size_t size) {
+
+    if (_incoming_description) {
+        log(V1_WARN, "[WARN] Desc. of #%i still incomplete - discard\n", _incoming_description->jobId);
+    }
+    DescriptionTransfer transfer;
+    transfer.jobId = jobId;
+    transfer.source = source;
+    transfer.data.reset(new std::vector<uint8_t>(size));
+    transfer.numChunks = std::max((size_t)1, (size + _desc_chunk_size - 1) / _desc_chunk_size);
+    transfer.arrivedChunks.resize(transfer.numChunks, false);
+    _incoming_description = std::move(transfer);
+
+    // Only receive the first chunk (which may be a stub) before posting any further chunks
+    postDescriptionChunks();
+}
+
+void Worker::postDescriptionChunks() {
+
+    auto& transfer = *_incoming_description;
+    // Max. number of chunk receives posted at the same time
+    const size_t window = transfer.numReceivedChunks == 0 ? 1 : 4;
+    while (transfer.numPostedChunks < transfer.numChunks 
+            && transfer.numPostedChunks - transfer.numReceivedChunks < window) {
+        size_t offset = transfer.numPostedChunks * _desc_chunk_size;
+        size_t size = std::min(_desc_chunk_size, transfer.data->size() - offset);
+        MyMpi::irecv(MPI_COMM_WORLD, transfer.source, MSG_SEND_JOB_DESCRIPTION, transfer.data, offset, size);
+        transfer.numPostedChunks++;
+    }
+}
+
+bool Worker::canRelayDescription(const JobRequest& req, bool alreadyAccepted) {
+
+    if (!_incoming_description || _incoming_description->jobId != req.jobId) return false;
+    // The first chunk must have arrived: it may have been a stub for an obsolete adoption
+    if (_incoming_description->numReceivedChunks == 0) return false;
+    // A child which resumes its job queries the volume, which may not be known yet
+    if (req.fullTransfer != 1 || !_job_db.has(req.jobId)) return false;
+
+    auto& tree = _job_db.get(req.jobId).getJobTree();
+    if (req.requestedNodeIndex == tree.getLeftChildIndex()) 
+        return alreadyAccepted || !tree.hasLeftChild();
+    if (req.requestedNodeIndex == tree.getRightChildIndex()) 
+        return alreadyAccepted || !tree.hasRightChild();
+    return false;
+}
+
+void Worker::relayDescriptionChunks(int rank, size_t firstChunk, size_t endChunk) {
+
+    auto& transfer = *_incoming_description;
+    for (size_t chunk = firstChunk; chunk < endChunk; chunk++) {
+        size_t offset = chunk * _desc_chunk_size;
+        size_t size = std::min(_desc_chunk_size, transfer.data->size() - offset);
+        MyMpi::isend(MPI_COMM_WORLD, rank, MSG_SEND_JOB_DESCRIPTION, transfer.data, offset, size);
+    }
 }
 
 void Worker::initJob(int jobId, const std::shared_ptr<std::vector<uint8_t>>& data, int senderRank) {
@@ -760,7 +910,7 @@ void Worker::handleNotifyNodeLeavingJob(MessageHandle& handle) {
     auto pruned = job.getJobTree().prune(handle.source, index);
 
     // If necessary, find replacement
-    if (pruned != JobTree::TreeRelative::NONE && index < job.getVolume()) {
+    if (pruned != JobTree::TreeRelative::NONE && JobPlacement::isChildWanted(index, job.getVolume())) {
 
         // Try to find a dormant child that is not the message source
         int tag = MSG_REQUEST_NODE_ONESHOT;
@@ -833,42 +983,11 @@ void Worker::handleNotifyResultFound(MessageHandle& handle) {
 
 void Worker::bounceJobRequest(JobRequest& request, int senderRank) {
 
-    // Increment #hops
-    request.numHops++;
-    int num = request.numHops;
+    // Increment #hops, find next destination
+    int nextRank = JobPlacement::bounce(request, _world_rank, senderRank, MyMpi::size(_comm), 
+            _hop_destinations, /*derandomize=*/_params.isNotNull("derandomize"));
     _sys_state.addLocal(SYSSTATE_NUMHOPS, 1);
 
-    // Show warning if #hops is a large power of two
-    if ((num >= 512) && ((num & (num - 1)) == 0)) {
-        log(V1_WARN, "[WARN] %s\n", request.toStr().c_str());
-    }
-
-    int nextRank;
-    if (_params.isNotNull("derandomize")) {
-        // Get random choice from bounce alternatives
-        nextRank = Random::choice(_hop_destinations);
-        if (_hop_destinations.size() > 2) {
-            // ... if possible while skipping the requesting node and the sender
-            while (nextRank == request.requestingNodeRank || nextRank == senderRank) {
-                nextRank = Random::choice(_hop_destinations);
-            }
-        }
-    } else {
-        // Generate pseudorandom permutation of this request
-        int n = MyMpi::size(_comm);
-        AdjustablePermutation perm(n, 3 * request.jobId + 7 * request.requestedNodeIndex + 11 * request.requestingNodeRank);
-        // Fetch next index of permutation based on number of hops
-        int permIdx = request.numHops % n;
-        nextRank = perm.get(permIdx);
-        if (n > 3) {
-            // ... if possible while skipping yourself, the requesting node, and the sender
-            while (nextRank == _world_rank || nextRank == request.requestingNodeRank || nextRank == senderRank) {
-                permIdx = (permIdx+1) % n;
-                nextRank = perm.get(permIdx);
-            }
-        }
-    }
-
     // Send request to "next" worker node
     log(LOG_ADD_DESTRANK | V5_DEBG, "Hop %s", nextRank, _job_db.toStr(request.jobId, request.requestedNodeIndex).c_str());
     MyMpi::isend(MPI_COMM_WORLD, nextRank, MSG_REQUEST_NODE, request);
@@ -879,9 +998,17 @@ void Worker::updateVolume(int jobId, int volume) {
     if (!_job_db.has(jobId)) return;
     Job &job = _job_db.get(jobId);
 
+    // A job whose description is still arriving may already grow
+    // in order to relay the description to its children
+    bool relaying = false;
     if (job.getState() != ACTIVE) {
-        // Job is not active right now
-        return;
+        if (!_incoming_description || _incoming_description->jobId != jobId 
+                || _incoming_description->numReceivedChunks == 0) {
+            // Job is not active right now
+            return;
+        }
+        _incoming_description->volume = volume;
+        relaying = true;
     }
 
     // Root node update message
@@ -889,7 +1016,7 @@ void Worker::updateVolume(int jobId, int volume) {
     if (thisIndex == 0 && job.getVolume() != volume) {
         log(V3_VERB, "%s : update v=%i\n", job.toStr(), volume);
     }
-    job.updateVolumeAndUsedCpu(volume);
+    if (!relaying) job.updateVolumeAndUsedCpu(volume);
 
     // Prepare volume update to propagate down the job tree
     IntPair payload(jobId, volume);
@@ -909,7 +1036,7 @@ void Worker::updateVolume(int jobId, int volume) {
             // Propagate volume update
             MyMpi::isend(MPI_COMM_WORLD, ranks[i], MSG_NOTIFY_VOLUME_UPDATE, payload);
 
-        } else if (nextIndex < volume) {
+        } else if (JobPlacement::isChildWanted(nextIndex, volume)) {
             // Grow
             log(V5_DEBG, "%s : grow\n", job.toStr());
             if (mono) job.getJobTree().updateJobNode(indices[i], indices[i]);
@@ -932,7 +1059,7 @@ void Worker::updateVolume(int jobId, int volume) {
     }
 
     // Shrink (and pause solving) if necessary
-    if (thisIndex > 0 && thisIndex >= volume) {
+    if (!relaying && JobPlacement::isNodeLeaving(thisIndex, volume)) {
         _job_db.suspend(jobId);
         MyMpi::isend(MPI_COMM_WORLD, job.getJobTree().getParentNodeRank(), MSG_NOTIFY_NODE_LEAVING_JOB, IntPair(jobId, thisIndex));
     }
@@ -1070,6 +1197,7 @@ Worker::~Worker() {
 
     // Send termination signal to the entire process group 
     Process::terminateAll();
+    SatProcessPool::release();
 
     if (_mpi_monitor_thread.joinable()) _mpi_monitor_thread.join();
 
@@ -7,6 +7,7 @@
 #include <string>
 #include <thread>
 #include <memory>
+#include <optional>
 
 #include "comm/mympi.hpp"
 #include "util/params.hpp"
@@ -43,12 +44,34 @@ private:
 
     std::thread _mpi_monitor_thread;
 
+    // Job description which is currently being received in chunks
+    // (there is at most one at a time since a node holds at most one commitment)
+    struct DescriptionTransfer {
+        int jobId;
+        int source;
+        std::shared_ptr<std::vector<uint8_t>> data;
+        size_t numChunks;
+        size_t numPostedChunks = 0;
+        size_t numReceivedChunks = 0;
+        // Chunks [0, numCompleteChunks) have all arrived
+        size_t numCompleteChunks = 0;
+        std::vector<bool> arrivedChunks;
+        // Volume of the job if already known during the transfer, 0 otherwise
+        int volume = 0;
+        // Children to which the arrived chunks are relayed
+        std::vector<int> relayTargets;
+    };
+    std::optional<DescriptionTransfer> _incoming_description;
+    size_t _desc_chunk_size;
+
 public:
     Worker(MPI_Comm comm, Parameters& params, const std::set<int>& _client_nodes) :
         _comm(comm), _world_rank(MyMpi::rank(MPI_COMM_WORLD)), _client_nodes(_client_nodes), 
-        _params(params), _job_db(_params, _comm), _sys_state(_comm)
+        _params(params), _job_db(_params, _comm), 
+        _msg_handler(_params.getIntParam("mbpi")), _sys_state(_comm)
         {
             _global_timeout = _params.getFloatParam("T");
+            _desc_chunk_size = 1024 * (size_t)std::max(1, _params.getIntParam("dcs"));
         }
 
     ~Worker();
@@ -84,6 +107,10 @@ private:
     void handleNotifyNodeLeavingJob(MessageHandle& handle);
     void handleNotifyResultFound(MessageHandle& handle);
     
+    void beginDescriptionTransfer(int jobId, int source, size_t size);
+    void postDescriptionChunks();
+    bool canRelayDescription(const JobRequest& req, bool alreadyAccepted);
+    void relayDescriptionChunks(int rank, size_t firstChunk, size_t endChunk);
     void initJob(int jobId, const std::shared_ptr<std::vector<uint8_t>>& data, int senderRank);
     void bounceJobRequest(JobRequest& request, int senderRank);
     void updateVolume(int jobId, int demand);